@@ -20,6 +20,7 @@
 #include "platform.h"
 #include "build.h"
 #include "draw.h"
+#include "tiles.h"
 
 int32_t pixelsAllowed = 10000000000;
 
@@ -98,6 +99,41 @@ IRAM_ATTR void hlineasm4(int32_t numPixels, int32_t shade, uint32_t i4, uint32_t
     }
 }
 
+//Same span as hlineasm4, but textureSetup points at a tileflat copy:
+//the column-major index is remapped into its 8x8 blocks.
+IRAM_ATTR void hlineasm4swizzled(int32_t numPixels, int32_t shade, uint32_t i4, uint32_t i5, uint8_t *dest){
+
+    int32_t shifter = ((256-machxbits_al) & 0x1f);
+    uint32_t source;
+    
+    uint8_t * texture = textureSetup;
+    uint8_t bits = bitsSetup;
+    
+    shade = shade & 0xffffff00;
+    numPixels++;
+    
+	if (!RENDER_DRAW_CEILING_AND_FLOOR)
+		return;
+
+    while (numPixels) {
+
+	    source = i5 >> shifter;
+	    source = shld(source,i4,bits);
+	    source = texture[FLATSWIZZLE(source,bits)];
+        
+		if (PIXEL_ALLOWED())
+			*dest = globalpalwritten[shade|source];
+        
+	    dest--;
+        
+	    i5 -= asm1;
+	    i4 -= asm2;
+        
+	    numPixels--;
+		
+    }
+}
+
 static int32_t rmach_eax;
 static int32_t rmach_ebx;
 static int32_t rmach_ecx;
@@ -34,6 +34,7 @@ void sethlinesizes(int32_t,int32_t,uint8_t *);
 
 
 void hlineasm4(int32_t,int32_t,uint32_t,uint32_t,uint8_t*);
+void hlineasm4swizzled(int32_t,int32_t,uint32_t,uint32_t,uint8_t*);
 void setuprhlineasm4(int32_t,int32_t,int32_t,int32_t,int32_t,int32_t);
 void rhlineasm4(int32_t,uint8_t*,int32_t,uint32_t,uint32_t,int32_t);
 void setuprmhlineasm4(int32_t,int32_t,int32_t,int32_t,int32_t,int32_t);
@@ -87,13 +87,17 @@ EXT_RAM_ATTR int32_t tilefileoffs[MAXTILES] __psram_bss("tilefileoffs");
 
 int32_t artsize = 0, cachesize = 0;
 
+/* Effect budget bookkeeping, see setspritefxclass() */
+EXT_RAM_ATTR uint8_t  spritefxclass[MAXSPRITES] __psram_bss("spritefxclass");
+EXT_RAM_ATTR short prevspritefx[MAXSPRITES] __psram_bss("prevspritefx");
+EXT_RAM_ATTR short nextspritefx[MAXSPRITES] __psram_bss("nextspritefx");
+short headspritefx[MAXFXCLASSES], tailspritefx[MAXFXCLASSES], spritefxcnt[MAXFXCLASSES];
+
 #ifdef RP2350_PSRAM
 /* Allocated in PSRAM via psram_data_init() */
 extern short *radarang, *radarang2;
-extern uint16_t *sqrtable, *shlookup;
 #else
 EXT_RAM_ATTR static short radarang[1280], radarang2[MAXXDIM+1];
-EXT_RAM_ATTR static uint16_t sqrtable[4096], shlookup[4096+256];
 #endif
 uint8_t  pow2char[8] = {1,2,4,8,16,32,64,-128};
 int32_t pow2long[32] =
@@ -327,22 +331,20 @@ uint16_t mapCRC;
 
 #include "draw.h"
 
+/*
+ Approximate sqrt: the top 12 significant bits (rounded to an even shift) go
+ through msqrtasm and the result is shifted back. This used to be two
+ lookup tables (sqrtable/shlookup) indexed the same way; the shifts now
+ come from a count-leading-zeros and the root from the FPU, which gives
+ the same value for every input without touching PSRAM.
+*/
 static __inline int32_t nsqrtasm(uint32_t  param)
 {
-    uint16_t *shlookup_a = (uint16_t*)shlookup;
-    uint16_t *sqrtable_a = (uint16_t*)sqrtable;
-    uint16_t cx;
+    uint32_t top = param>>12;
+    int32_t k = top ? ((33-__builtin_clz(top))>>1) : 0;
 
-    if (param & 0xff000000)
-        cx = shlookup_a[(param>>24)+4096];
-    else
-        cx = shlookup_a[param>>12];
-
-    param = param >> (cx&0xff);
-    param = ((param&0xffff0000)|sqrtable_a[param]);
-    param = param >> ((cx&0xff00)>>8);
-
-    return param;
+    param >>= (k<<1);
+    return ((uint32_t)msqrtasm((param<<18)+131072)<<1)>>(10-k);
 }
 
 static __inline int32_t krecipasm(int32_t i)
@@ -724,6 +726,9 @@ IRAM_ATTR static int32_t getpalookup(int32_t davis, int32_t dashade)
 }
 
 
+//Set by ceilscan/florscan: the hline texture is a tileflat copy.
+static uint8_t globalflatswizzled;
+
 IRAM_ATTR static void hline (int32_t xr, int32_t yp)
 {
     int32_t xl, r, s;
@@ -738,6 +743,11 @@ IRAM_ATTR static void hline (int32_t xr, int32_t yp)
     asm2 = globaly2*r;
     s = (getpalookup(mulscale16(r,globvis),globalshade)<<8);
 
+    if (globalflatswizzled)
+    {
+        hlineasm4swizzled(xr-xl,s,globalx2*r+globalypanning,globaly1*r+globalxpanning,ylookup[yp]+xr+frameoffset);
+        return;
+    }
     hlineasm4(xr-xl,s,globalx2*r+globalypanning,globaly1*r+globalxpanning,ylookup[yp]+xr+frameoffset);
 }
 
@@ -801,6 +811,7 @@ static void ceilscan (int32_t x1, int32_t x2, int32_t sectnum)
     if (tiles[globalpicnum].animFlags&192)
         globalpicnum += animateoffs(globalpicnum);
 
+    setflatpic(globalpicnum);
     TILE_MakeAvailable(globalpicnum);
     
     globalbufplc = tiles[globalpicnum].data;
@@ -889,7 +900,10 @@ static void ceilscan (int32_t x1, int32_t x2, int32_t sectnum)
     globaly1 = (-globalx1-globaly1)*halfxdimen;
     globalx2 = (globalx2-globaly2)*halfxdimen;
 
-    sethlinesizes(picsiz[globalpicnum]&15,picsiz[globalpicnum]>>4,globalbufplc);
+    //Opaque spans read the block-swizzled copy when the tile has one.
+    globalflatswizzled = tiles[globalpicnum].flat;
+    sethlinesizes(picsiz[globalpicnum]&15,picsiz[globalpicnum]>>4,
+                  globalflatswizzled ? tileflat(globalpicnum) : globalbufplc);
 
     globalx2 += globaly2*(x1-1);
     globaly1 += globalx1*(x1-1);
@@ -1039,6 +1053,7 @@ static void florscan (int32_t x1, int32_t x2, int32_t sectnum)
         globalpicnum += animateoffs(globalpicnum);
 
     //If the texture is not in RAM: Load it !!
+    setflatpic(globalpicnum);
     TILE_MakeAvailable(globalpicnum);
     
     //Check where is the texture in RAM
@@ -1138,7 +1153,10 @@ static void florscan (int32_t x1, int32_t x2, int32_t sectnum)
     globalx2 = (globalx2-globaly2)*halfxdimen;
 
     //Setup the drawing routine paramters
-    sethlinesizes(picsiz[globalpicnum]&15,picsiz[globalpicnum]>>4,globalbufplc);
+    //Opaque spans read the block-swizzled copy when the tile has one.
+    globalflatswizzled = tiles[globalpicnum].flat;
+    sethlinesizes(picsiz[globalpicnum]&15,picsiz[globalpicnum]>>4,
+                  globalflatswizzled ? tileflat(globalpicnum) : globalbufplc);
 
     globalx2 += globaly2*(x1-1);
     globaly1 += globalx1*(x1-1);
@@ -1283,6 +1301,20 @@ static void florscan (int32_t x1, int32_t x2, int32_t sectnum)
  *
  *  --ryan.
  */
+//Coarsest mip level whose texels are still at most one pixel apart
+//vertically for a column stepping vinc (a power-of-two tile's vince).
+static __inline int32_t wallmiplevel(int32_t vinc, int32_t maxmip)
+{
+    uint32_t step;
+    int32_t lev;
+
+    step = ((uint32_t)klabs(vinc))>>globalshiftval;
+    lev = 0;
+    while ((lev < maxmip) && (step >= (2u<<lev)))
+        lev++;
+    return lev;
+}
+
 IRAM_ATTR static void wallscan(int32_t x1, int32_t x2,
                      int16_t *uwal, int16_t *dwal,
                      int32_t *swal, int32_t *lwal)
@@ -1290,7 +1322,9 @@ IRAM_ATTR static void wallscan(int32_t x1, int32_t x2,
     int32_t x, xnice, ynice;
     intptr_t i;
     uint8_t* fpalookup;
-    int32_t y1ve[4], y2ve[4], u4, d4, z, tileWidth, tsizy;
+    uint8_t* mipdata[MAXMIPLEVELS+1];
+    int32_t y1ve[4], y2ve[4], u4, d4, z, tileWidth, tsizy, maxmip, lev;
+    intptr_t colidx[4];
     uint8_t  bad;
 
     tileWidth = tiles[globalpicnum].dim.width;
@@ -1319,6 +1353,12 @@ IRAM_ATTR static void wallscan(int32_t x1, int32_t x2,
 
     fpalookup = palookup[globalpal];
 
+    //Mip levels use the power-of-two addressing below: column index and
+    //vertical position are both shifted down by the level.
+    maxmip = (mipmaps && xnice && ynice) ? tiles[globalpicnum].mips : 0;
+    for(z=0; z<=maxmip; z++)
+        mipdata[z] = tilemip(globalpicnum,z);
+
     setupvlineasm(globalshiftval);
 
     //Starting on the left column of the wall, check the occlusion arrays.
@@ -1345,14 +1385,23 @@ IRAM_ATTR static void wallscan(int32_t x1, int32_t x2,
                 bufplce[0] &= tileWidth;
         }
 
+        vince[0] = swal[x]*globalyscale;
+        vplce[0] = globalzd + vince[0]*(y1ve[0]-globalhoriz+1);
+
+        if (maxmip)
+        {
+            lev = wallmiplevel(vince[0],maxmip);
+            setupvlineasm(globalshiftval+lev);
+            bufplce[0] = ((bufplce[0]>>lev)<<(tsizy-lev)) + (intptr_t)mipdata[lev];
+            vlineasm1(vince[0],palookupoffse[0],y2ve[0]-y1ve[0]-1,vplce[0],(uint8_t *)bufplce[0],x+frameoffset+ylookup[y1ve[0]]);
+            continue;
+        }
+
         if (ynice == 0)
             bufplce[0] *= tsizy;
         else
             bufplce[0] <<= tsizy;
 
-        vince[0] = swal[x]*globalyscale;
-        vplce[0] = globalzd + vince[0]*(y1ve[0]-globalhoriz+1);
-
         vlineasm1(vince[0],palookupoffse[0],y2ve[0]-y1ve[0]-1,vplce[0],bufplce[0]+tiles[globalpicnum].data,x+frameoffset+ylookup[y1ve[0]]);
     }
     
@@ -1375,6 +1424,7 @@ IRAM_ATTR static void wallscan(int32_t x1, int32_t x2,
                 if (xnice == 0) i %= tileWidth;
                 else i &= tileWidth;
             }
+            colidx[z] = i;
             if (ynice == 0)
                 i *= tsizy;
             else
@@ -1388,6 +1438,18 @@ IRAM_ATTR static void wallscan(int32_t x1, int32_t x2,
         if (bad == 15)
             continue;
 
+        //The four columns share one shift: use the finest level any of them needs.
+        if (maxmip)
+        {
+            lev = maxmip;
+            for(z=0; z<4; z++)
+                if (!(bad&pow2char[z]))
+                    lev = min(lev,wallmiplevel(vince[z],maxmip));
+            setupvlineasm(globalshiftval+lev);
+            for(z=0; z<4; z++)
+                bufplce[z] = ((colidx[z]>>lev)<<(tsizy-lev)) + (intptr_t)mipdata[lev];
+        }
+
         palookupoffse[0] = fpalookup+(getpalookup((int32_t)mulscale16(swal[x],globvis),globalshade)<<8);
         palookupoffse[3] = fpalookup+(getpalookup((int32_t)mulscale16(swal[x+3],globvis),globalshade)<<8);
 
@@ -1458,14 +1520,23 @@ IRAM_ATTR static void wallscan(int32_t x1, int32_t x2,
                 bufplce[0] &= tileWidth;
         }
         
+        vince[0] = swal[x]*globalyscale;
+        vplce[0] = globalzd + vince[0]*(y1ve[0]-globalhoriz+1);
+
+        if (maxmip)
+        {
+            lev = wallmiplevel(vince[0],maxmip);
+            setupvlineasm(globalshiftval+lev);
+            bufplce[0] = ((bufplce[0]>>lev)<<(tsizy-lev)) + (intptr_t)mipdata[lev];
+            vlineasm1(vince[0],palookupoffse[0],y2ve[0]-y1ve[0]-1,vplce[0],(uint8_t *)bufplce[0],x+frameoffset+ylookup[y1ve[0]]);
+            continue;
+        }
+
         if (ynice == 0) bufplce[0]
             *= tsizy;
         else
             bufplce[0] <<= tsizy;
 
-        vince[0] = swal[x]*globalyscale;
-        vplce[0] = globalzd + vince[0]*(y1ve[0]-globalhoriz+1);
-
         vlineasm1(vince[0],palookupoffse[0],y2ve[0]-y1ve[0]-1,vplce[0],bufplce[0]+tiles[globalpicnum].data,x+frameoffset+ylookup[y1ve[0]]);
     }
     faketimerhandler();
@@ -2250,6 +2321,34 @@ static int wallmost(short *mostbuf, int32_t w, int32_t sectnum, uint8_t  dastat)
 }
 
 
+/*
+ Far clip: portals whose nearest visible depth is past farclip world
+ units are not flooded. drawrooms raises the visibility so shade 0 has
+ faded to the darkest palookup by then, and the opening is filled with
+ that color and closed like a solid wall. 0 disables it.
+*/
+int farclip = 0;
+int govfarclip = 0;
+static int32_t viewfarclip; // Nearer of farclip and govfarclip, set by drawrooms
+
+static void farclipfill(int32_t x1, int32_t x2)
+{
+    int32_t x, y;
+    uint8_t  col, *p;
+
+    col = palookup[0][(numpalookups-1)<<8];
+    for(x=x1; x<=x2; x++)
+        if (umost[x] <= dmost[x])
+        {
+            p = ylookup[umost[x]]+x+frameoffset;
+            for(y=umost[x]; y<dmost[x]; y++, p+=bytesperline)
+                *p = col;
+            umost[x] = 1;
+            dmost[x] = 0;
+            numhits--;
+        }
+}
+
 static void drawalls(int32_t bunch)
 {
     sectortype *sec, *nextsec;
@@ -2551,7 +2650,17 @@ static void drawalls(int32_t bunch)
             }
             if (numhits < 0) return;
             if ((!(wal->cstat&32)) && ((visitedSectors[nextsectnum>>3]&pow2char[nextsectnum&7]) == 0)){
-                if (umost[x2] < dmost[x2])
+                if ((viewfarclip > 0) &&
+                    (min(pvWalls[z].screenSpaceCoo[0][VEC_DIST],pvWalls[z].screenSpaceCoo[1][VEC_DIST]) > (viewfarclip<<8)))
+                {
+                    farclipfill(x1,x2);
+                    smostwallcnt = startsmostwallcnt;
+                    smostcnt = startsmostcnt;
+                    smostwall[smostwallcnt] = z;
+                    smostwalltype[smostwallcnt] = 0;
+                    smostwallcnt++;
+                }
+                else if (umost[x2] < dmost[x2])
                     scansector((short) nextsectnum);
                 else
                 {
@@ -2789,10 +2898,35 @@ IRAM_ATTR int wallfront(int32_t pvWallID1, int32_t pvWallID2)
 }
 
 
+/*
+ * drawrooms asks bunchfront about the same pair of bunches again for every
+ * bunch it draws. Bunches do not change while a view is drawn and a bunch
+ * is identified by its first pvWall, so the wallfront answer for an
+ * overlapping pair is kept here, tagged with the drawrooms call it
+ * belongs to. Pairs that do not overlap on screen are not cached, they
+ * are cheaper to test than to look up.
+ */
+#define BUNCHCACHESIZ 512
+static uint32_t bunchcachekey[BUNCHCACHESIZ];
+static int8_t bunchcacheres[BUNCHCACHESIZ];
+static uint32_t bunchcachegen = 0;
+
+static void newbunchcache(void)
+{
+    //The generation lives in the top 10 bits of the key: clear on wrap.
+    bunchcachegen = (bunchcachegen+1)&1023;
+    if (bunchcachegen == 0)
+    {
+        clearbuf(bunchcachekey,BUNCHCACHESIZ,0L);
+        bunchcachegen = 1;
+    }
+}
+
 //Return 1 if bunch firstBunchID is in from of bunch secondBunchID.
 static int bunchfront(int32_t firstBunchID, int32_t secondBunchID)
 {
-    int32_t x1b1, x2b1, x1b2, x2b2;
+    int32_t x1b1, x2b1, x1b2, x2b2, res;
+    uint32_t key, h;
 
     
     x1b1 = pvWalls[bunchfirst[firstBunchID]].screenSpaceCoo[0][VEC_COL];
@@ -2813,6 +2947,11 @@ static int bunchfront(int32_t firstBunchID, int32_t secondBunchID)
 	}
 
 
+    key = (bunchcachegen<<22)|((uint32_t)bunchfirst[firstBunchID]<<11)|(uint32_t)bunchfirst[secondBunchID];
+    h = ((uint32_t)bunchfirst[firstBunchID]*31+(uint32_t)bunchfirst[secondBunchID])&(BUNCHCACHESIZ-1);
+    if (bunchcachekey[h] == key)
+        return(bunchcacheres[h]);
+
     if (x1b1 >= x1b2)
     {
 		//Get the last wall in the bunch2.
@@ -2821,7 +2960,7 @@ static int bunchfront(int32_t firstBunchID, int32_t secondBunchID)
 			pvWalls[lastWallID].screenSpaceCoo[1][VEC_COL]<x1b1; 
 			lastWallID=bunchWallsList[lastWallID]);
 
-        return(wallfront(bunchfirst[firstBunchID],lastWallID));
+        res = wallfront(bunchfirst[firstBunchID],lastWallID);
     }
 	else
 	{
@@ -2831,8 +2970,12 @@ static int bunchfront(int32_t firstBunchID, int32_t secondBunchID)
 			pvWalls[lastWallID].screenSpaceCoo[1][VEC_COL]<x1b2; 
 			lastWallID=bunchWallsList[lastWallID]);
 
-		return(wallfront(lastWallID,bunchfirst[secondBunchID]));
+		res = wallfront(lastWallID,bunchfirst[secondBunchID]);
 	}
+
+    bunchcachekey[h] = key;
+    bunchcacheres[h] = (int8_t)res;
+    return(res);
 }
 
 int pixelRenderable = 0;
@@ -2888,7 +3031,14 @@ void drawrooms(int32_t daposx, int32_t daposy, int32_t daposz,short daang, int32
 
     i = mulscale16(xdimenscale,viewingrangerecip);
     globalpisibility = mulscale16(parallaxvisibility,i);
-    globalvisibility = mulscale16(visibility,i);
+    //Shade grows by visibility/2^19 per world unit: fade out by farclip.
+    viewfarclip = farclip;
+    if ((govfarclip > 0) && ((viewfarclip <= 0) || (govfarclip < viewfarclip)))
+        viewfarclip = govfarclip;
+    j = visibility;
+    if (viewfarclip > 0)
+        j = max(j,(numpalookups<<19)/viewfarclip);
+    globalvisibility = mulscale16(j,i);
     globalhisibility = mulscale16(globalvisibility,xyaspect);
     globalcisibility = mulscale8(globalhisibility,320);
 
@@ -2994,6 +3144,7 @@ void drawrooms(int32_t daposx, int32_t daposy, int32_t daposz,short daang, int32
 
 	//Build the list of potentially visible wall in to "bunches".
     scansector(globalcursectnum);
+    newbunchcache();
 
     if (inpreparemirror)
     {
@@ -3314,6 +3465,17 @@ int loadboard(char  *filename, int32_t *daposx, int32_t *daposy,
         kread16(fil,&sect->extra);
     }
 
+    //Mark flats before the game precaches them, so their first load
+    //already carries the block-swizzled copy.
+    clearbuf(&flatpic[0],(int32_t)((MAXTILES+31)>>5),0L);
+    for (x = 0; x < numsectors; x++)
+    {
+        if ((uint32_t)sector[x].ceilingpicnum < (uint32_t)MAXTILES)
+            setflatpic(sector[x].ceilingpicnum);
+        if ((uint32_t)sector[x].floorpicnum < (uint32_t)MAXTILES)
+            setflatpic(sector[x].floorpicnum);
+    }
+
     kread16(fil,&numwalls);
     for (x = 0, w = &wall[0]; x < numwalls; x++, w++)
     {
@@ -3533,33 +3695,12 @@ int saveboard(char  *filename, int32_t *daposx, int32_t *daposy,
 }
 
 
-static void initksqrt(void)
-{
-    int32_t i, j, k;
-
-    j = 1;
-    k = 0;
-    for(i=0; i<4096; i++)
-    {
-        if (i >= j) {
-            j <<= 2;
-            k++;
-        }
-        sqrtable[i] = (uint16_t)(msqrtasm((i<<18)+131072)<<1);
-        shlookup[i] = (k<<1)+((10-k)<<8);
-        if (i < 256) shlookup[i+4096] = ((k+6)<<1)+((10-(k+6))<<8);
-    }
-}
-
-
 static void loadtables(void)
 {
     int32_t i, fil;
 
     if (tablesloaded == 0)
     {
-        initksqrt();
-
         for(i=0; i<2048; i++) reciptable[i] = divscale30(2048L,i+2048);
 
         if ((fil = TCkopen4load("tables.dat",0)) != -1)
@@ -3709,7 +3850,11 @@ void initengine(void)
 
     tiles = heap_caps_malloc(sizeof(tile_t) * MAXTILES, MALLOC_CAP_SPIRAM);
     for(i=0 ; i < MAXTILES ; i++)
+    {
         tiles[i].data = NULL;
+        tiles[i].mips = 0;
+        tiles[i].flat = 0;
+    }
 
     clearbuf(&show2dsector[0],(int32_t)((MAXSECTORS+3)>>5),0L);
     clearbuf(&show2dsprite[0],(int32_t)((MAXSPRITES+3)>>5),0L);
@@ -4689,12 +4834,165 @@ __inline int ksqrt(int32_t num)
 
 
 
+/*
+ * Batched face sprite pass (batchsprites). Opaque face sprites are not
+ * drawn as drawmasks meets them: their clipped columns are precomputed
+ * into spritecols[] and drawn later, one screen column at a time, with the
+ * spans of every queued sprite in that column in painter's order. Each
+ * column of the frame buffer and of each tile is then streamed once per
+ * batch instead of once per sprite. Anything else that draws in drawmasks
+ * flushes the batch first, so the output is identical to maskwallscan.
+ */
+#define MAXBATCHCOLS 512
+#define MAXBATCHJOBS 32
+
+typedef struct
+{
+    int32_t vince, vplce;
+    uint8_t *buf, *pal;
+    int16_t y1, cnt;
+} spritecoltype;
+
+typedef struct
+{
+    int16_t lx, rx, col;
+    uint8_t shift;
+} spritejobtype;
+
+int batchsprites = 0;
+static spritecoltype spritecols[MAXBATCHCOLS];
+static spritejobtype spritejobs[MAXBATCHJOBS];
+static int32_t spritecolcnt = 0, spritejobcnt = 0, batchlx, batchrx;
+
+IRAM_ATTR static void flushspritebatch(void)
+{
+    int32_t x, j, shift;
+    spritecoltype *c;
+
+    if (spritejobcnt == 0)
+        return;
+
+    shift = -1;
+    for(x=batchlx; x<=batchrx; x++)
+        for(j=0; j<spritejobcnt; j++)
+        {
+            if ((x < spritejobs[j].lx) || (x > spritejobs[j].rx)) continue;
+            c = &spritecols[spritejobs[j].col+x-spritejobs[j].lx];
+            if (c->cnt <= 0) continue;
+
+            if (spritejobs[j].shift != shift)
+            {
+                shift = spritejobs[j].shift;
+                setupmvlineasm(shift);
+            }
+            mvlineasm1(c->vince,c->pal,c->cnt-1,c->vplce,c->buf,frameoffset+x+ylookup[c->y1]);
+        }
+
+    spritejobcnt = 0;
+    spritecolcnt = 0;
+    faketimerhandler();
+}
+
+/* Same clipping and texture setup as maskwallscan, queued instead of drawn. */
+IRAM_ATTR static void batchmaskwallscan(int32_t x1, int32_t x2,
+                                        short *uwal, short *dwal,
+                                        int32_t *swal, int32_t *lwal)
+{
+    int32_t x, i, y1, y2, xnice, ynice, tileWidth, tileHeight;
+    uint8_t* fpalookup;
+    spritecoltype *c;
+    spritejobtype *job;
+
+    tileWidth = tiles[globalpicnum].dim.width;
+    tileHeight = tiles[globalpicnum].dim.height;
+    setgotpic(globalpicnum);
+
+    if ((tileWidth <= 0) || (tileHeight <= 0))
+        return;
+    if ((uwal[x1] > ydimen) && (uwal[x2] > ydimen))
+        return;
+    if ((dwal[x1] < 0) && (dwal[x2] < 0))
+        return;
+
+    if ((spritejobcnt >= MAXBATCHJOBS) || (spritecolcnt+x2-x1+1 > MAXBATCHCOLS))
+        flushspritebatch();
+    if (x2-x1+1 > MAXBATCHCOLS)
+    {
+        maskwallscan(x1,x2,uwal,dwal,swal,lwal);
+        return;
+    }
+
+    /* Loading a tile may evict one the queued columns still point into. */
+    if (tiles[globalpicnum].data == NULL)
+    {
+        flushspritebatch();
+        TILE_MakeAvailable(globalpicnum);
+    }
+
+    xnice = (pow2long[picsiz[globalpicnum]&15] == tileWidth);
+    if (xnice)
+        tileWidth = (tileWidth-1);
+
+    ynice = (pow2long[picsiz[globalpicnum]>>4] == tileHeight);
+    if (ynice)
+        tileHeight = (picsiz[globalpicnum]>>4);
+
+    fpalookup = palookup[globalpal];
+
+    job = &spritejobs[spritejobcnt++];
+    job->lx = x1;
+    job->rx = x2;
+    job->col = spritecolcnt;
+    job->shift = globalshiftval;
+
+    for(x=x1; x<=x2; x++)
+    {
+        c = &spritecols[spritecolcnt++];
+
+        y1 = max(uwal[x],startumost[x+windowx1]-windowy1);
+        y2 = min(dwal[x],startdmost[x+windowx1]-windowy1);
+        c->cnt = y2-y1;
+        if (c->cnt <= 0) continue;
+        c->y1 = y1;
+
+        c->pal = fpalookup+(getpalookup((int32_t)mulscale16(swal[x],globvis),globalshade)<<8);
+
+        i = lwal[x] + globalxpanning;
+        if (i >= tileWidth) {
+            if (xnice == 0) i %= tileWidth;
+            else i &= tileWidth;
+        }
+        if (ynice == 0)
+            i *= tileHeight;
+        else
+            i <<= tileHeight;
+        c->buf = tiles[globalpicnum].data+i;
+
+        c->vince = swal[x]*globalyscale;
+        c->vplce = globalzd + c->vince*(y1-globalhoriz+1);
+    }
+
+    if (spritejobcnt == 1)
+    {
+        batchlx = x1;
+        batchrx = x2;
+    }
+    else
+    {
+        if (x1 < batchlx) batchlx = x1;
+        if (x2 > batchrx) batchrx = x2;
+    }
+}
+
+
 static void drawmaskwall(short damaskwallcnt)
 {
     int32_t i, j, k, x, z, sectnum, z1, z2, lx, rx;
     sectortype *sec, *nsec;
     walltype *wal;
 
+    flushspritebatch();
+
     //Retrive pvWall ID.
     z = maskwall[damaskwallcnt];
     
@@ -4907,6 +5205,10 @@ IRAM_ATTR static void drawsprite (int32_t snum)
     spritenum = tspr->owner;
     cstat = tspr->cstat;
 
+    /* Only opaque face sprites join the batch; keep painter's order for the rest. */
+    if (((cstat&48) != 0) || (cstat&2))
+        flushspritebatch();
+
     if ((cstat&48) != 48)
     {
         if (tiles[tilenum].animFlags&192)
@@ -5117,7 +5419,12 @@ IRAM_ATTR static void drawsprite (int32_t snum)
         clearbuf(&swall[lx],rx-lx+1,mulscale19(yp,xdimscale));
 
         if ((cstat&2) == 0)
-            maskwallscan(lx,rx,uwall,dwall,swall,lwall);
+        {
+            if (batchsprites)
+                batchmaskwallscan(lx,rx,uwall,dwall,swall,lwall);
+            else
+                maskwallscan(lx,rx,uwall,dwall,swall,lwall);
+        }
         else
             transmaskwallscan(lx,rx);
     }
@@ -5777,8 +6084,8 @@ void drawmasks(void)
         ys = tspriteptr[i]->y-globalposy;
         yp = dmulscale6(xs,cosviewingrangeglobalang,ys,sinviewingrangeglobalang);
         
-        /* RP2350 PERF: Cull very distant sprites (beyond ~32K units) */
-        if (yp > (32000<<8))
+        /* RP2350 PERF: Cull very distant sprites (beyond ~32K units or the far clip) */
+        if ((yp > (32000<<8)) || ((viewfarclip > 0) && (yp > (viewfarclip<<8))))
         {
             spritesortcnt--;
             if (i != spritesortcnt)
@@ -5914,6 +6221,7 @@ void drawmasks(void)
     }
     while (spritesortcnt > 0) drawsprite(--spritesortcnt);
     while (maskwallcnt > 0) drawmaskwall(--maskwallcnt);
+    flushspritebatch();
 }
 
 
@@ -5931,6 +6239,8 @@ int setsprite(short spritenum, int32_t newx, int32_t newy, int32_t newz)
         return(-1);
     if (tempsectnum != sprite[spritenum].sectnum)
         changespritesect(spritenum,tempsectnum);
+    else
+        touchsector(tempsectnum,0);
 
     return(0);
 }
@@ -5965,6 +6275,16 @@ void initspritelists(void)
     }
     prevspritestat[0] = -1;
     nextspritestat[MAXSPRITES-1] = -1;
+
+    for(i=0; i<MAXSPRITES; i++)
+        spritefxclass[i] = 0;
+    for(i=0; i<MAXFXCLASSES; i++)
+    {
+        headspritefx[i] = tailspritefx[i] = -1;
+        spritefxcnt[i] = 0;
+    }
+
+    resetzrangecache();
 }
 
 
@@ -5995,6 +6315,7 @@ int insertspritesect(short sectnum)
     headspritesect[sectnum] = blanktouse;
 
     sprite[blanktouse].sectnum = sectnum;
+    touchsector(sectnum,0);
 
     return(blanktouse);
 }
@@ -6020,6 +6341,7 @@ int insertspritestat(short statnum)
     headspritestat[statnum] = blanktouse;
 
     sprite[blanktouse].statnum = statnum;
+    spritefxclass[blanktouse] = 0;
 
     return(blanktouse);
 }
@@ -6037,6 +6359,8 @@ int deletespritesect(short deleteme)
     if (sprite[deleteme].sectnum == MAXSECTORS)
         return(-1);
 
+    touchsector(sprite[deleteme].sectnum,0);
+
     if (headspritesect[sprite[deleteme].sectnum] == deleteme)
         headspritesect[sprite[deleteme].sectnum] = nextspritesect[deleteme];
 
@@ -6058,6 +6382,8 @@ int deletespritestat(short deleteme)
     if (sprite[deleteme].statnum == MAXSTATUS)
         return(-1);
 
+    setspritefxclass(deleteme,0);
+
     if (headspritestat[sprite[deleteme].statnum] == deleteme)
         headspritestat[sprite[deleteme].statnum] = nextspritestat[deleteme];
 
@@ -6096,6 +6422,43 @@ int changespritestat(short spritenum, short newstatnum)
 }
 
 
+/*
+ * Budgeted effect sprites.  The game tags a sprite with an effect class
+ * once it is spawned; the engine keeps a per-class count and a list in
+ * spawn order (oldest at the head) so the game can pick a sprite to
+ * retire without walking a stat list.  The tag dies with the stat list
+ * entry, so deletesprite and changespritestat keep the counts honest.
+ */
+void setspritefxclass(short spritenum, uint8_t  fxclass)
+{
+    short cls;
+
+    cls = spritefxclass[spritenum];
+    if (cls == fxclass) return;
+
+    if ((cls > 0) && (cls < MAXFXCLASSES))
+    {
+        if (prevspritefx[spritenum] >= 0) nextspritefx[prevspritefx[spritenum]] = nextspritefx[spritenum];
+        else headspritefx[cls] = nextspritefx[spritenum];
+        if (nextspritefx[spritenum] >= 0) prevspritefx[nextspritefx[spritenum]] = prevspritefx[spritenum];
+        else tailspritefx[cls] = prevspritefx[spritenum];
+        spritefxcnt[cls]--;
+    }
+
+    spritefxclass[spritenum] = fxclass;
+    prevspritefx[spritenum] = nextspritefx[spritenum] = -1;
+
+    if ((fxclass > 0) && (fxclass < MAXFXCLASSES))
+    {
+        prevspritefx[spritenum] = tailspritefx[fxclass];
+        if (tailspritefx[fxclass] >= 0) nextspritefx[tailspritefx[fxclass]] = spritenum;
+        else headspritefx[fxclass] = spritenum;
+        tailspritefx[fxclass] = spritenum;
+        spritefxcnt[fxclass]++;
+    }
+}
+
+
 int nextsectorneighborz(short sectnum, int32_t thez,
                         short topbottom, short direction)
 {
@@ -7310,6 +7673,307 @@ int clipmove (int32_t *x, int32_t *y, int32_t *z, short *sectnum,
 }
 
 
+/*
+ * Point-sized projectile motion.  Projectiles (statnum 4) move with a tiny
+ * walldist, so clipmove's MAXCLIPDIST flood turns every blocking wall and
+ * clippable sprite around them into clip lines, on every tic.  This walks the
+ * sector graph along the tic's displacement instead, and only keeps the clip
+ * lines that can actually touch the swept segment.
+ *
+ * If the segment is clear the result is what clipmove would have returned
+ * (goal position, retval 0).  On any hit we hand the move to clipmove itself,
+ * so the hit classification, slide and final position stay identical.
+ */
+int clipmoveprojectile (int32_t *x, int32_t *y, int32_t *z, short *sectnum,
+                        int32_t xvect, int32_t yvect, int32_t walldist, int32_t ceildist,
+                        int32_t flordist, uint32_t  cliptype)
+{
+    walltype *wal, *wal2;
+    spritetype *spr;
+    sectortype *sec2;
+    int32_t i, j, k, l, clipsectcnt, startwall, endwall, cstat, dasect;
+    int32_t x1, y1, x2, y2, dx, dy, dax, day, daz, daz2, bsz;
+    int32_t goalx, goaly, gx, gy, intx, inty;
+    int32_t sxmin, symin, sxmax, symax, xmin, ymin, xmax, ymax;
+    int32_t xoff, yoff, xspan, yspan, xrepeat, yrepeat, cosang, sinang, tilenum;
+    int32_t dasprclipmask, dawalclipmask, clipyou;
+
+    if (((xvect|yvect) == 0) || (*sectnum < 0)) return(0);
+
+    goalx = (*x) + (xvect>>14);
+    goaly = (*y) + (yvect>>14);
+    gx = goalx-(*x);
+    gy = goaly-(*y);
+
+    /* Tight box: anything whose clip lines can reach the swept segment */
+    sxmin = min(*x,goalx)-walldist; sxmax = max(*x,goalx)+walldist;
+    symin = min(*y,goaly)-walldist; symax = max(*y,goaly)+walldist;
+    /* Wide box: sectors whose sprites may still reach it with their clipdist */
+    xmin = sxmin-MAXCLIPDIST; xmax = sxmax+MAXCLIPDIST;
+    ymin = symin-MAXCLIPDIST; ymax = symax+MAXCLIPDIST;
+
+    dawalclipmask = (cliptype&65535);
+    dasprclipmask = (cliptype>>16);
+
+    clipnum = 0;
+    clipsectorlist[0] = (*sectnum);
+    clipsectcnt = 0;
+    clipsectnum = 1;
+    do
+    {
+        /* Keep headroom for one wall's or sprite's worth of lines */
+        if ((clipnum > MAXCLIPNUM-8) || (clipsectnum > MAXCLIPNUM-1))
+            return(clipmove(x,y,z,sectnum,xvect,yvect,walldist,ceildist,flordist,cliptype));
+
+        dasect = clipsectorlist[clipsectcnt++];
+        startwall = sector[dasect].wallptr;
+        endwall = startwall + sector[dasect].wallnum;
+        for(j=startwall,wal=&wall[startwall]; j<endwall; j++,wal++)
+        {
+            wal2 = &wall[wal->point2];
+            if ((wal->x < xmin) && (wal2->x < xmin)) continue;
+            if ((wal->x > xmax) && (wal2->x > xmax)) continue;
+            if ((wal->y < ymin) && (wal2->y < ymin)) continue;
+            if ((wal->y > ymax) && (wal2->y > ymax)) continue;
+
+            x1 = wal->x;
+            y1 = wal->y;
+            x2 = wal2->x;
+            y2 = wal2->y;
+
+            dx = x2-x1;
+            dy = y2-y1;
+            if (dx*((*y)-y1) < ((*x)-x1)*dy) continue;  /* If wall's not facing you */
+
+            if (dx > 0) dax = dx*(ymin-y1);
+            else dax = dx*(ymax-y1);
+            if (dy > 0) day = dy*(xmax-x1);
+            else day = dy*(xmin-x1);
+            if (dax >= day) continue;
+
+            clipyou = 0;
+            if ((wal->nextsector < 0) || (wal->cstat&dawalclipmask)) clipyou = 1;
+            else if (editstatus == 0)
+            {
+                if (rintersect(*x,*y,0,gx,gy,0,x1,y1,x2,y2,&dax,&day,&daz) == 0)
+                    dax = *x, day = *y;
+                daz = getflorzofslope((short)dasect,dax,day);
+                daz2 = getflorzofslope(wal->nextsector,dax,day);
+
+                sec2 = &sector[wal->nextsector];
+                if (daz2 < daz-(1<<8))
+                    if ((sec2->floorstat&1) == 0)
+                        if ((*z) >= daz2-(flordist-1)) clipyou = 1;
+                if (clipyou == 0)
+                {
+                    daz = getceilzofslope((short)dasect,dax,day);
+                    daz2 = getceilzofslope(wal->nextsector,dax,day);
+                    if (daz2 > daz+(1<<8))
+                        if ((sec2->ceilingstat&1) == 0)
+                            if ((*z) <= daz2+(ceildist-1)) clipyou = 1;
+                }
+            }
+
+            if (clipyou)
+            {
+                /* Far walls can't reach the segment, so skip their 5 lines */
+                if ((x1 < sxmin) && (x2 < sxmin)) continue;
+                if ((x1 > sxmax) && (x2 > sxmax)) continue;
+                if ((y1 < symin) && (y2 < symin)) continue;
+                if ((y1 > symax) && (y2 > symax)) continue;
+
+                bsz = walldist;
+                if (gx < 0) bsz = -bsz;
+                addclipline(x1-bsz,y1-bsz,x1-bsz,y1+bsz,(short)j+32768);
+                addclipline(x2-bsz,y2-bsz,x2-bsz,y2+bsz,(short)j+32768);
+                bsz = walldist;
+                if (gy < 0) bsz = -bsz;
+                addclipline(x1+bsz,y1-bsz,x1-bsz,y1-bsz,(short)j+32768);
+                addclipline(x2+bsz,y2-bsz,x2-bsz,y2-bsz,(short)j+32768);
+
+                dax = walldist;
+                if (dy > 0) dax = -dax;
+                day = walldist;
+                if (dx < 0) day = -day;
+                addclipline(x1+dax,y1+day,x2+dax,y2+day,(short)j+32768);
+            }
+            else
+            {
+                for(i=clipsectnum-1; i>=0; i--)
+                    if (wal->nextsector == clipsectorlist[i]) break;
+                if (i < 0) clipsectorlist[clipsectnum++] = wal->nextsector;
+            }
+        }
+
+        for(j=headspritesect[dasect]; j>=0; j=nextspritesect[j])
+        {
+            spr = &sprite[j];
+            cstat = spr->cstat;
+            if ((cstat&dasprclipmask) == 0) continue;
+            x1 = spr->x;
+            y1 = spr->y;
+            switch(cstat&48)
+            {
+            case 0:
+                bsz = (spr->clipdist<<2)+walldist;
+                if ((x1+bsz < sxmin) || (x1-bsz > sxmax)) break;
+                if ((y1+bsz < symin) || (y1-bsz > symax)) break;
+
+                k = ((tiles[spr->picnum].dim.height*spr->yrepeat)<<2);
+                if (cstat&128) daz = spr->z+(k>>1);
+                else daz = spr->z;
+
+                if (tiles[spr->picnum].animFlags&0x00ff0000)
+                    daz -= ((int32_t)((int8_t )((tiles[spr->picnum].animFlags>>16)&255))*spr->yrepeat<<2);
+
+                if (((*z) < daz+ceildist) && ((*z) > daz-k-flordist))
+                {
+                    if (gx < 0) bsz = -bsz;
+                    addclipline(x1-bsz,y1-bsz,x1-bsz,y1+bsz,(short)j+49152);
+                    bsz = (spr->clipdist<<2)+walldist;
+                    if (gy < 0) bsz = -bsz;
+                    addclipline(x1+bsz,y1-bsz,x1-bsz,y1-bsz,(short)j+49152);
+                }
+                break;
+            case 16:
+                k = ((tiles[spr->picnum].dim.height*spr->yrepeat)<<2);
+                if (cstat&128) daz = spr->z+(k>>1);
+                else daz = spr->z;
+                if (tiles[spr->picnum].animFlags&0x00ff0000)
+                    daz -= ((int32_t)((int8_t  )((tiles[spr->picnum].animFlags>>16)&255))*spr->yrepeat<<2);
+                daz2 = daz-k;
+                daz += ceildist;
+                daz2 -= flordist;
+                if (((*z) >= daz) || ((*z) <= daz2)) break;
+
+                tilenum = spr->picnum;
+                xoff = (int32_t)((int8_t  )((tiles[tilenum].animFlags>>8)&255))+((int32_t)spr->xoffset);
+                if ((cstat&4) > 0) xoff = -xoff;
+                k = spr->ang;
+                l = spr->xrepeat;
+                dax = sintable[k&2047]*l;
+                day = sintable[(k+1536)&2047]*l;
+                l = tiles[tilenum].dim.width;
+                k = (l>>1)+xoff;
+                x1 -= mulscale16(dax,k);
+                x2 = x1+mulscale16(dax,l);
+                y1 -= mulscale16(day,k);
+                y2 = y1+mulscale16(day,l);
+
+                if ((x1 < sxmin) && (x2 < sxmin)) break;
+                if ((x1 > sxmax) && (x2 > sxmax)) break;
+                if ((y1 < symin) && (y2 < symin)) break;
+                if ((y1 > symax) && (y2 > symax)) break;
+
+                dax = mulscale14(sintable[(spr->ang+256+512)&2047],walldist);
+                day = mulscale14(sintable[(spr->ang+256)&2047],walldist);
+
+                if ((x1-(*x))*(y2-(*y)) >= (x2-(*x))*(y1-(*y)))   /* Front */
+                {
+                    addclipline(x1+dax,y1+day,x2+day,y2-dax,(short)j+49152);
+                }
+                else
+                {
+                    if ((cstat&64) != 0) break;
+                    addclipline(x2-dax,y2-day,x1-day,y1+dax,(short)j+49152);
+                }
+
+                /* Side blocker */
+                if ((x2-x1)*((*x)-x1) + (y2-y1)*((*y)-y1) < 0)
+                {
+                    addclipline(x1-day,y1+dax,x1+dax,y1+day,(short)j+49152);
+                }
+                else if ((x1-x2)*((*x)-x2) + (y1-y2)*((*y)-y2) < 0)
+                {
+                    addclipline(x2+day,y2-dax,x2-dax,y2-day,(short)j+49152);
+                }
+                break;
+            case 32:
+                daz = spr->z+ceildist;
+                daz2 = spr->z-flordist;
+                if (((*z) >= daz) || ((*z) <= daz2)) break;
+                if ((cstat&64) != 0)
+                    if (((*z) > spr->z) == ((cstat&8)==0)) break;
+
+                tilenum = spr->picnum;
+                xoff = (int32_t)((int8_t  )((tiles[tilenum].animFlags>>8)&255))+((int32_t)spr->xoffset);
+                yoff = (int32_t)((int8_t  )((tiles[tilenum].animFlags>>16)&255))+((int32_t)spr->yoffset);
+                if ((cstat&4) > 0) xoff = -xoff;
+                if ((cstat&8) > 0) yoff = -yoff;
+
+                k = spr->ang;
+                cosang = sintable[(k+512)&2047];
+                sinang = sintable[k];
+                xspan = tiles[tilenum].dim.width;
+                xrepeat = spr->xrepeat;
+                yspan = tiles[tilenum].dim.height;
+                yrepeat = spr->yrepeat;
+
+                dax = ((xspan>>1)+xoff)*xrepeat;
+                day = ((yspan>>1)+yoff)*yrepeat;
+                rxi[0] = x1 + dmulscale16(sinang,dax,cosang,day);
+                ryi[0] = y1 + dmulscale16(sinang,day,-cosang,dax);
+                l = xspan*xrepeat;
+                rxi[1] = rxi[0] - mulscale16(sinang,l);
+                ryi[1] = ryi[0] + mulscale16(cosang,l);
+                l = yspan*yrepeat;
+                k = -mulscale16(cosang,l);
+                rxi[2] = rxi[1]+k;
+                rxi[3] = rxi[0]+k;
+                k = -mulscale16(sinang,l);
+                ryi[2] = ryi[1]+k;
+                ryi[3] = ryi[0]+k;
+
+                if ((rxi[0] < sxmin) && (rxi[1] < sxmin) && (rxi[2] < sxmin) && (rxi[3] < sxmin)) break;
+                if ((rxi[0] > sxmax) && (rxi[1] > sxmax) && (rxi[2] > sxmax) && (rxi[3] > sxmax)) break;
+                if ((ryi[0] < symin) && (ryi[1] < symin) && (ryi[2] < symin) && (ryi[3] < symin)) break;
+                if ((ryi[0] > symax) && (ryi[1] > symax) && (ryi[2] > symax) && (ryi[3] > symax)) break;
+
+                dax = mulscale14(sintable[(spr->ang-256+512)&2047],walldist);
+                day = mulscale14(sintable[(spr->ang-256)&2047],walldist);
+
+                if ((rxi[0]-(*x))*(ryi[1]-(*y)) < (rxi[1]-(*x))*(ryi[0]-(*y)))
+                {
+                    addclipline(rxi[1]-day,ryi[1]+dax,rxi[0]+dax,ryi[0]+day,(short)j+49152);
+                }
+                else if ((rxi[2]-(*x))*(ryi[3]-(*y)) < (rxi[3]-(*x))*(ryi[2]-(*y)))
+                {
+                    addclipline(rxi[3]+day,ryi[3]-dax,rxi[2]-dax,ryi[2]-day,(short)j+49152);
+                }
+
+                if ((rxi[1]-(*x))*(ryi[2]-(*y)) < (rxi[2]-(*x))*(ryi[1]-(*y)))
+                {
+                    addclipline(rxi[2]-dax,ryi[2]-day,rxi[1]-day,ryi[1]+dax,(short)j+49152);
+                }
+                else if ((rxi[3]-(*x))*(ryi[0]-(*y)) < (rxi[0]-(*x))*(ryi[3]-(*y)))
+                {
+                    addclipline(rxi[0]+dax,ryi[0]+day,rxi[3]+day,ryi[3]-dax,(short)j+49152);
+                }
+                break;
+            }
+        }
+    } while (clipsectcnt < clipsectnum);
+
+    /* Anything in the way: let clipmove classify it and do the slide */
+    intx = goalx;
+    inty = goaly;
+    if (raytrace(*x, *y, &intx, &inty) >= 0)
+        return(clipmove(x,y,z,sectnum,xvect,yvect,walldist,ceildist,flordist,cliptype));
+
+    for(j=0; j<clipsectnum; j++)
+        if (inside(goalx,goaly,clipsectorlist[j]) == 1)
+        {
+            *x = goalx;
+            *y = goaly;
+            *sectnum = clipsectorlist[j];
+            return(0);
+        }
+
+    /* Left every sector we know of; clipmove owns the global search */
+    return(clipmove(x,y,z,sectnum,xvect,yvect,walldist,ceildist,flordist,cliptype));
+}
+
+
 int pushmove(int32_t *x, int32_t *y, int32_t *z, short *sectnum,
              int32_t walldist, int32_t ceildist, int32_t flordist,
              uint32_t  cliptype)
@@ -8055,6 +8719,152 @@ void getzrange(int32_t x, int32_t y, int32_t z, short sectnum,
 }
 
 
+/*
+ * Sector modification epochs.  Anything that moves geometry or sprites
+ * inside a sector calls touchsector(), and anything that changes a wall's
+ * cstat calls touchwall(); both stamp sectors with a new value of a global
+ * counter.  A cached getzrange result stays valid while
+ * none of the sectors it flooded has been stamped after it was computed.
+ * Sprite state is changed in too many places (CON cstat, sizeat, direct
+ * z writes) to stamp reliably, so results are only cached and reused while
+ * no other sprite in the flood can block, and the querying sprite's own
+ * shape is part of the key.
+ */
+#define ZRANGECACHESIZ 256
+#define ZRANGECACHESECTS 16
+
+typedef struct
+{
+    int32_t x, y, z, walldist;
+    uint32_t cliptype, epoch;
+    int32_t ceilz, ceilhit, florz, florhit;
+    short cstat, picnum;  /* Shape of the querying sprite */
+    uint8_t  xrepeat, yrepeat;
+    short spritenum, sectnum, numsects;
+    short sects[ZRANGECACHESECTS];
+} zrangecachetype;
+
+EXT_RAM_ATTR static uint32_t sectorepoch[MAXSECTORS] __psram_bss("sectorepoch");
+EXT_RAM_ATTR static zrangecachetype zrangecache[ZRANGECACHESIZ] __psram_bss("zrangecache");
+static uint32_t globalepoch = 0;
+
+
+void touchsector(short sectnum, uint8_t  neighbors)
+{
+    walltype *wal;
+    int32_t i;
+
+    if ((sectnum < 0) || (sectnum >= numsectors)) return;
+
+    globalepoch++;
+    sectorepoch[sectnum] = globalepoch;
+    if (neighbors == 0) return;
+
+    /* Geometry changes also affect whether neighbours flood into us */
+    wal = &wall[sector[sectnum].wallptr];
+    for(i=sector[sectnum].wallnum; i>0; i--,wal++)
+        if (wal->nextsector >= 0)
+            sectorepoch[wal->nextsector] = globalepoch;
+}
+
+
+/* Wall cstat decides whether getzrange floods through, so stamp both sides */
+void touchwall(short wallnum)
+{
+    if ((wallnum < 0) || (wallnum >= numwalls)) return;
+
+    touchsector(sectorofwall(wallnum),0);
+    touchsector(wall[wallnum].nextsector,0);
+}
+
+
+void resetzrangecache(void)
+{
+    int32_t i;
+
+    for(i=0; i<ZRANGECACHESIZ; i++)
+        zrangecache[i].spritenum = -1;
+    for(i=0; i<MAXSECTORS; i++)
+        sectorepoch[i] = 0;
+    globalepoch = 0;
+}
+
+
+/* Whether a sprite other than spritenum in the listed sectors can block */
+static uint8_t  zrangeblocked(short spritenum, short *sects, int32_t numsects, uint32_t cliptype)
+{
+    int32_t i, j, sprmask = (cliptype>>16);
+
+    for(i=numsects-1; i>=0; i--)
+        for(j=headspritesect[sects[i]]; j>=0; j=nextspritesect[j])
+            if ((j != spritenum) && (sprite[j].cstat&sprmask))
+                return 1;
+    return 0;
+}
+
+/*
+ * getzrange() on behalf of a sprite.  Idle and slow actors ask the same
+ * question every tic, so reuse the last answer while the query and the
+ * epochs of every sector it flooded are unchanged.
+ */
+void getzrangesprite(short spritenum, int32_t x, int32_t y, int32_t z, short sectnum,
+                     int32_t *ceilz, int32_t *ceilhit, int32_t *florz, int32_t *florhit,
+                     int32_t walldist, uint32_t  cliptype)
+{
+    zrangecachetype *zc;
+    int32_t i;
+
+    zc = &zrangecache[spritenum&(ZRANGECACHESIZ-1)];
+    if ((zc->spritenum == spritenum) && (zc->sectnum == sectnum) &&
+        (zc->x == x) && (zc->y == y) && (zc->z == z) &&
+        (zc->walldist == walldist) && (zc->cliptype == cliptype) &&
+        (zc->cstat == sprite[spritenum].cstat) && (zc->picnum == sprite[spritenum].picnum) &&
+        (zc->xrepeat == sprite[spritenum].xrepeat) && (zc->yrepeat == sprite[spritenum].yrepeat))
+    {
+        for(i=zc->numsects-1; i>=0; i--)
+            if (sectorepoch[zc->sects[i]] > zc->epoch) break;
+        if ((i < 0) && !zrangeblocked(spritenum,zc->sects,zc->numsects,cliptype))
+        {
+            *ceilz = zc->ceilz;
+            *ceilhit = zc->ceilhit;
+            *florz = zc->florz;
+            *florhit = zc->florhit;
+            return;
+        }
+    }
+
+    getzrange(x,y,z,sectnum,ceilz,ceilhit,florz,florhit,walldist,cliptype);
+
+    /* Too many sectors to revalidate cheaply, or other sprites involved */
+    if ((sectnum < 0) || (clipsectnum > ZRANGECACHESECTS) ||
+        zrangeblocked(spritenum,clipsectorlist,clipsectnum,cliptype))
+    {
+        zc->spritenum = -1;
+        return;
+    }
+
+    zc->spritenum = spritenum;
+    zc->sectnum = sectnum;
+    zc->x = x;
+    zc->y = y;
+    zc->z = z;
+    zc->walldist = walldist;
+    zc->cliptype = cliptype;
+    zc->cstat = sprite[spritenum].cstat;
+    zc->picnum = sprite[spritenum].picnum;
+    zc->xrepeat = sprite[spritenum].xrepeat;
+    zc->yrepeat = sprite[spritenum].yrepeat;
+    zc->epoch = globalepoch;
+    zc->ceilz = *ceilz;
+    zc->ceilhit = *ceilhit;
+    zc->florz = *florz;
+    zc->florhit = *florhit;
+    zc->numsects = clipsectnum;
+    for(i=0; i<clipsectnum; i++)
+        zc->sects[i] = clipsectorlist[i];
+}
+
+
 void setview(int32_t x1, int32_t y1, int32_t x2, int32_t y2)
 {
     int32_t i;
@@ -52,6 +52,7 @@ int deletespritestat (int16_t deleteme);
 int insertspritestat(int16_t statnum);
 int changespritesect(int16_t spritenum, int16_t newsectnum);
 int changespritestat(int16_t spritenum, int16_t newstatnum);
+void setspritefxclass(int16_t spritenum, uint8_t  fxclass);
 void loadtile(int16_t tilenume);
 
 
@@ -72,7 +73,12 @@ void setbrightness(uint8_t  dabrightness, uint8_t  *dapal);
 int screencapture(char  *filename, uint8_t  inverseit);
 void getmousevalues(int16_t *mousx, int16_t *mousy, int16_t *bstatus);
 int clipmove (int32_t *x, int32_t *y, int32_t *z, int16_t *sectnum, int32_t xvect,int32_t yvect, int32_t walldist, int32_t ceildist,int32_t flordist, uint32_t  cliptype);
+int clipmoveprojectile (int32_t *x, int32_t *y, int32_t *z, int16_t *sectnum, int32_t xvect,int32_t yvect, int32_t walldist, int32_t ceildist,int32_t flordist, uint32_t  cliptype);
 void getzrange(int32_t x, int32_t y, int32_t z, int16_t sectnum,int32_t *ceilz, int32_t *ceilhit, int32_t *florz, int32_t *florhit,int32_t walldist, uint32_t  cliptype);
+void getzrangesprite(int16_t spritenum, int32_t x, int32_t y, int32_t z, int16_t sectnum,int32_t *ceilz, int32_t *ceilhit, int32_t *florz, int32_t *florhit,int32_t walldist, uint32_t  cliptype);
+void touchsector(int16_t sectnum, uint8_t  neighbors);
+void touchwall(int16_t wallnum);
+void resetzrangecache(void);
 int getangle(int32_t xvect, int32_t yvect);
 void alignceilslope(int16_t dasect, int32_t x, int32_t y, int32_t z);
 void alignflorslope(int16_t dasect, int32_t x, int32_t y, int32_t z);
@@ -156,6 +162,27 @@ int clipinsidebox(int32_t x, int32_t y, int16_t wallnum, int32_t walldist);
     extern EXT_RAM_ATTR int32_t tilefileoffs[MAXTILES];
     extern int32_t totalclocklock;
 
+//Effect budget classes, maintained by the sprite stat lists
+#define MAXFXCLASSES 8
+    extern EXT_RAM_ATTR uint8_t  spritefxclass[MAXSPRITES];
+    extern EXT_RAM_ATTR int16_t prevspritefx[MAXSPRITES], nextspritefx[MAXSPRITES];
+    extern int16_t headspritefx[MAXFXCLASSES], tailspritefx[MAXFXCLASSES], spritefxcnt[MAXFXCLASSES];
+
+//Queue opaque face sprites in drawmasks and draw them column by column
+    extern int batchsprites;
+
+//Build half-size levels for power-of-two tiles at load and use them for distant walls
+    extern int mipmaps;
+
+//Keep an 8x8-block copy of floor and ceiling tiles for the flat span renderer
+    extern int swizzleflats;
+
+//World distance past which portals are not flooded and the view fades out (0 = unlimited)
+    extern int farclip;
+
+//Far clip set by the game's frame-time governor; the nearer of the two applies (0 = none)
+    extern int govfarclip;
+
 #ifdef __cplusplus
 }
 #endif
@@ -569,10 +569,19 @@ int32_t compress(uint8_t  *lzwinbuf, int32_t uncompleng, uint8_t  *lzwoutbuf)
 	return(uncompleng+4);
 }
 
+/*
+ * Every string in the dictionary has already been written to the output
+ * once: code c is the string of the code read when c was created, plus the
+ * first byte of the next one, and those are adjacent in the output. So
+ * instead of walking prefix chains and reversing, lzwbuf2[c] holds where
+ * that copy starts and lzwbuf3[c] its length, and each code is one forward
+ * copy (byte by byte when it overlaps its own source, as in KwKwK).
+ */
 int32_t uncompress(uint8_t  *lzwinbuf, int32_t compleng, uint8_t  *lzwoutbuf)
 {
 	int32_t strtot, currstr, numbits, oneupnumbits;
 	int32_t i, dat, leng, bitcnt, outbytecnt, *longptr;
+	uint8_t  *src, *dst;
 	short *shortptr;
     
 	shortptr = (short *)lzwinbuf;
@@ -582,7 +591,6 @@ int32_t uncompress(uint8_t  *lzwinbuf, int32_t compleng, uint8_t  *lzwoutbuf)
 		copybuf((void *)((lzwinbuf)+4),(void *)((lzwoutbuf)),((compleng-4)+3)>>2);
 		return((int32_t )shortptr[0]); /* uncompleng */
 	}
-	for(i=255;i>=0;i--) { lzwbuf2[i] = (short) i; lzwbuf3[i] = (short) i; }
 	currstr = 256; bitcnt = (4<<3); outbytecnt = 0;
 	numbits = 8; oneupnumbits = (1<<8);
 	do
@@ -593,15 +601,25 @@ int32_t uncompress(uint8_t  *lzwinbuf, int32_t compleng, uint8_t  *lzwoutbuf)
 		if ((dat&((oneupnumbits>>1)-1)) > ((currstr-1)&((oneupnumbits>>1)-1)))
         { dat &= ((oneupnumbits>>1)-1); bitcnt--; }
         
-		lzwbuf3[currstr] = (short) dat;
-        
-		for(leng=0;dat>=256;leng++,dat=lzwbuf3[dat])
-			lzwbuf1[leng] = (uint8_t ) lzwbuf2[dat];
-        
-		lzwoutbuf[outbytecnt++] = (uint8_t ) dat;
-		for(i=leng-1;i>=0;i--) lzwoutbuf[outbytecnt++] = lzwbuf1[i];
+		lzwbuf2[currstr] = (short) outbytecnt;
+		if (dat < 256)
+		{
+			lzwoutbuf[outbytecnt++] = (uint8_t ) dat;
+			lzwbuf3[currstr] = 2;
+		}
+		else
+		{
+			leng = lzwbuf3[dat];
+			src = &lzwoutbuf[lzwbuf2[dat]];
+			dst = &lzwoutbuf[outbytecnt];
+			if (src+leng <= dst)
+				memcpy(dst,src,leng);
+			else
+				for(i=0;i<leng;i++) dst[i] = src[i];
+			outbytecnt += leng;
+			lzwbuf3[currstr] = (short) (leng+1);
+		}
         
-		lzwbuf2[currstr-1] = (short) dat; lzwbuf2[currstr] = (short) dat;
 		currstr++;
 		if (currstr > oneupnumbits) { numbits++; oneupnumbits <<= 1; }
 	} while (currstr < strtot);
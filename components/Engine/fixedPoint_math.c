@@ -53,3 +53,54 @@ IRAM_ATTR void qinterpolatedown16short(int32_t* bufptr, int32_t num, int32_t val
     for(i=0;i<num;i++) { sptr[i] = (short)(val>>16); val += add; }
 }
 
+
+/*
+ * 64/32 division without __aeabi_ldivmod. When the quotient fits in 32 bits
+ * it is built from two 32/16 digit divisions on the hardware divider after
+ * normalizing the divisor (Hacker's Delight, divlu). Truncation and the
+ * wrap of the final cast are the same as (int32_t)(n/d).
+ */
+IRAM_ATTR int32_t div64_32(int64_t n, int32_t d)
+{
+	uint64_t un;
+	uint32_t u1, u0, v, vn1, vn0, un32, un21, un10, un1, un0, q1, q0, rhat;
+	int s;
+
+	un = (n < 0) ? (0-(uint64_t)n) : (uint64_t)n;
+	v = (d < 0) ? (0-(uint32_t)d) : (uint32_t)d;
+	u1 = (uint32_t)(un>>32);
+	u0 = (uint32_t)un;
+	if (u1 >= v) //Quotient does not fit in 32 bits (or d == 0).
+		return (int32_t)(n/d);
+
+	s = __builtin_clz(v);
+	v <<= s;
+	vn1 = v>>16;
+	vn0 = v&0xffff;
+	un32 = (s == 0) ? u1 : ((u1<<s)|(u0>>(32-s)));
+	un10 = u0<<s;
+	un1 = un10>>16;
+	un0 = un10&0xffff;
+
+	q1 = un32/vn1;
+	rhat = un32-q1*vn1;
+	while ((q1 >= 65536) || (q1*vn0 > ((rhat<<16)|un1)))
+	{
+		q1--;
+		rhat += vn1;
+		if (rhat >= 65536) break;
+	}
+
+	un21 = (un32<<16)+un1-q1*v;
+	q0 = un21/vn1;
+	rhat = un21-q0*vn1;
+	while ((q0 >= 65536) || (q0*vn0 > ((rhat<<16)|un0)))
+	{
+		q0--;
+		rhat += vn1;
+		if (rhat >= 65536) break;
+	}
+
+	q0 |= q1<<16;
+	return (int32_t)(((n < 0) != (d < 0)) ? (0-q0) : q0);
+}
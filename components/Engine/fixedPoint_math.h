@@ -22,30 +22,21 @@ static __inline void swapchar2(uint8_t  *p1, uint8_t  *p2, int xsiz)
     swapchar(p1 + 1, p2 + xsiz);
 }
 
+/* floor(sqrt(input)), bit-exact with Ken's original bit-serial loop for all
+   32-bit inputs: the FPU estimate is off by at most one and is corrected
+   with an integer square. */
 static __inline int32_t msqrtasm(uint32_t input)
 {
-	uint32_t a,b;
-
-	a = 0x40000000l;		// mov eax, 0x40000000
-	b = 0x20000000l;		// mov ebx, 0x20000000
-    
-	do {				// begit:
-		if (input >= a) {		// cmp ecx, eax	 /  jl skip
-			input -= a;		// sub ecx, eax
-			a += b*4;	// lea eax, [eax+ebx*4]
-		}			// skip:
-		a -= b;			// sub eax, ebx
-		a >>= 1;		// shr eax, 1
-		b >>= 2;		// shr ebx, 2
-	}
-    while (b);			// jnz begit
-    
-	if (input >= a)			// cmp ecx, eax
-		a++;			// sbb eax, -1
-    
-	a >>= 1;			// shr eax, 1
-    
-	return a;
+	uint32_t r = (uint32_t)__builtin_sqrtf((float)input);
+
+	if (r > 65535)
+		r = 65535;
+	if (r*r > input)
+		r--;
+	else if ((r < 65535) && ((r+1)*(r+1) <= input))
+		r++;
+
+	return r;
 }
 
 void vlin16first (int32_t i1, int32_t i2);
@@ -57,9 +48,18 @@ static inline int64_t mul32_64(int32_t i1,int32_t i2)
 {
 	return (int64_t)i1*i2;
 }
+/* internal use: 64/32 = 32bit, same result as (int32_t)(n/d) */
+int32_t div64_32(int64_t n, int32_t d);
+static inline int32_t fixeddiv(int64_t n, int32_t d)
+{
+	//Most numerators fit in 32 bits: a single hardware divide.
+	if ((n == (int32_t)n) && (n != INT32_MIN))
+		return (int32_t)n/d;
+	return div64_32(n,d);
+}
 static inline int scale (int32_t input1, int32_t input2, int32_t input3)
 {
-	return (int)(mul32_64(input1,input2)/(int64_t)input3);
+	return (int)fixeddiv(mul32_64(input1,input2),input3);
 }
 static inline int mulscale (int32_t input1, int32_t input2, int32_t input3)
 {
@@ -75,7 +75,7 @@ static inline int tmulscale(int32_t i1, int32_t i2, int32_t i3, int32_t i4, int3
 }
 static inline int32_t divscale(int32_t i1, int32_t i2, int32_t i3)
 {
-	return (int32_t)(((int64_t)i1<<i3)/i2);
+	return fixeddiv((int64_t)i1<<i3,i2);
 }
 
 #define DEFFUNCS \
@@ -26,11 +26,18 @@ uint8_t  *pic = NULL;
 
 EXT_RAM_ATTR uint8_t  gotpic[(MAXTILES+7)>>3];
 
+int mipmaps = 0;
+
+EXT_RAM_ATTR uint8_t  flatpic[(MAXTILES+7)>>3];
+int swizzleflats = 0;
+
 void setviewtotile(short tilenume, int32_t tileWidth, int32_t tileHeight)
 {
     int32_t i, j;
     
     /* DRAWROOMS TO TILE BACKUP&SET CODE */
+    tiles[tilenume].mips = 0; //Rendered into: the levels would be stale.
+    tiles[tilenume].flat = 0;
     tiles[tilenume].dim.width = tileWidth;
     tiles[tilenume].dim.height = tileHeight;
     bakxsiz[setviewcnt] = tileWidth;
@@ -59,40 +66,78 @@ void setviewtotile(short tilenume, int32_t tileWidth, int32_t tileHeight)
 
 
 
-void squarerotatetile(short tilenume)
+/*
+ * Tiles are column-major and usually live in PSRAM, so a byte-by-byte
+ * transpose touches a new cache line for every other access.  Transpose in
+ * 16x16 blocks staged through SRAM instead: each block is read and written
+ * back as 16 contiguous runs of up to 16 bytes.
+ */
+#define TRANSPOSEBLOCK 16
+static uint8_t  transposea[TRANSPOSEBLOCK*TRANSPOSEBLOCK];
+static uint8_t  transposeb[TRANSPOSEBLOCK*TRANSPOSEBLOCK];
+
+/* Stage a block of 'cols' columns by 'rows' rows; 'stride' is the column length */
+static void loadtransposeblock(uint8_t  *blk, const uint8_t  *src, int32_t stride, int32_t cols, int32_t rows)
 {
-    int32_t i, j, k;
-    uint8_t  *ptr1, *ptr2;
-    
-    dimensions_t tileDim;
-    
-    tileDim.width = tiles[tilenume].dim.width;
-    tileDim.height = tiles[tilenume].dim.height;
-    
-    /* supports square tiles only for rotation part */
-    if (tileDim.width == tileDim.height)
+    int32_t x;
+
+    for(x=0; x<cols; x++)
+        memcpy(&blk[x*TRANSPOSEBLOCK],&src[x*stride],rows);
+}
+
+/* Write a staged block back transposed: 'rows' columns by 'cols' rows */
+static void storetransposeblock(uint8_t  *dst, const uint8_t  *blk, int32_t stride, int32_t cols, int32_t rows)
+{
+    int32_t x, y;
+    uint8_t  *d;
+
+    for(y=0; y<rows; y++)
     {
-        k = (tileDim.width<<1);
-        for(i=tileDim.width-1; i>=0; i--)
+        d = &dst[y*stride];
+        for(x=0; x<cols; x++)
+            d[x] = blk[x*TRANSPOSEBLOCK+y];
+    }
+}
+
+/* In-place transpose of a square siz x siz buffer */
+void transposesquare(uint8_t  *buf, int32_t siz)
+{
+    int32_t bx, by, cw, rh;
+
+    for(by=0; by<siz; by+=TRANSPOSEBLOCK)
+    {
+        rh = min(TRANSPOSEBLOCK,siz-by);
+        for(bx=by; bx<siz; bx+=TRANSPOSEBLOCK)
         {
-            ptr1 = tiles[tilenume].data+i*(tileDim.width+1);
-            ptr2 = ptr1;
-            if ((i&1) != 0) {
-                ptr1--;
-                ptr2 -= tileDim.width;
-                swapchar(ptr1,ptr2);
-            }
-            for(j=(i>>1)-1; j>=0; j--)
+            cw = min(TRANSPOSEBLOCK,siz-bx);
+
+            /* Block at columns bx.., rows by.. and its mirror at columns by.., rows bx.. */
+            loadtransposeblock(transposea,&buf[bx*siz+by],siz,cw,rh);
+            if (bx == by)
             {
-                ptr1 -= 2;
-                ptr2 -= k;
-                swapchar2(ptr1,ptr2,tileDim.width);
+                storetransposeblock(&buf[by*siz+bx],transposea,siz,cw,rh);
+                continue;
             }
+            loadtransposeblock(transposeb,&buf[by*siz+bx],siz,rh,cw);
+            storetransposeblock(&buf[by*siz+bx],transposea,siz,cw,rh);
+            storetransposeblock(&buf[bx*siz+by],transposeb,siz,rh,cw);
         }
     }
 }
 
 
+void squarerotatetile(short tilenume)
+{
+    /* supports square tiles only for rotation part */
+    if (tiles[tilenume].dim.width == tiles[tilenume].dim.height)
+    {
+        tiles[tilenume].mips = 0;
+        tiles[tilenume].flat = 0;
+        transposesquare(tiles[tilenume].data,tiles[tilenume].dim.width);
+    }
+}
+
+
 
 //1. Lock a picture in the cache system.
 //2. Mark it as used in the bitvector tracker.
@@ -108,10 +153,143 @@ IRAM_ATTR void setgotpic(int32_t tilenume)
 
 
 
+/*
+ Mip levels: level l is the tile at half the size of level l-1, stored
+ column-major right after it in the same cache block, so a tile and its
+ levels are loaded and evicted together. Only power-of-two tiles get them,
+ since the wall renderer addresses those with shifts and masks.
+*/
+static int32_t tilemiplevels(short tilenume)
+{
+    int32_t w, h, levels;
+
+    w = tiles[tilenume].dim.width;
+    h = tiles[tilenume].dim.height;
+    if ((pow2long[picsiz[tilenume]&15] != w) || (pow2long[picsiz[tilenume]>>4] != h))
+        return 0;
+
+    levels = 0;
+    while ((levels < MAXMIPLEVELS) && ((w>>(levels+1)) >= 4) && ((h>>(levels+1)) >= 4))
+        levels++;
+    return levels;
+}
+
+uint8_t* tilemip(short tilenume, int32_t level)
+{
+    uint8_t *ptr;
+    int32_t l;
+
+    ptr = tiles[tilenume].data;
+    for(l=0; l<level; l++)
+        ptr += (tiles[tilenume].dim.width>>l)*(tiles[tilenume].dim.height>>l);
+    return ptr;
+}
+
+//Each texel of the next level is whichever of its four source texels is
+//closest in RGB to their average, so no new colors appear and 255
+//(transparent) wins only when it covers half the block.
+static void buildtilemips(short tilenume)
+{
+    uint8_t  *src, *dst, *s, c[4];
+    int32_t l, x, y, k, sw, sh, r, g, b, n, best, bestd, d;
+
+    for(l=1; l<=tiles[tilenume].mips; l++)
+    {
+        src = tilemip(tilenume,l-1);
+        dst = tilemip(tilenume,l);
+        sw = tiles[tilenume].dim.width>>(l-1);
+        sh = tiles[tilenume].dim.height>>(l-1);
+
+        for(x=0; x<(sw>>1); x++)
+            for(y=0; y<(sh>>1); y++)
+            {
+                s = src + (x<<1)*sh + (y<<1);
+                c[0] = s[0]; c[1] = s[1]; c[2] = s[sh]; c[3] = s[sh+1];
+
+                r = g = b = n = 0;
+                for(k=0; k<4; k++)
+                    if (c[k] != 255)
+                    {
+                        r += palette[c[k]*3];
+                        g += palette[c[k]*3+1];
+                        b += palette[c[k]*3+2];
+                        n++;
+                    }
+
+                if (n <= 2)
+                {
+                    *dst++ = 255;
+                    continue;
+                }
+
+                best = 0; bestd = 0x7fffffff;
+                for(k=0; k<4; k++)
+                {
+                    if (c[k] == 255)
+                        continue;
+                    d = sqr(palette[c[k]*3]*n-r) + sqr(palette[c[k]*3+1]*n-g) + sqr(palette[c[k]*3+2]*n-b);
+                    if (d < bestd)
+                    {
+                        bestd = d;
+                        best = c[k];
+                    }
+                }
+                *dst++ = (uint8_t )best;
+            }
+    }
+}
+
+/*
+ Flats: tiles drawn as floors or ceilings get a second copy of level 0
+ in 8x8 texel blocks after the mip levels, so an angled span stays within
+ a few PSRAM cache lines instead of crossing a column per texel. Walls
+ keep reading the column-major original.
+*/
+void setflatpic(int32_t tilenume)
+{
+    flatpic[tilenume>>3] |= pow2char[tilenume&7];
+}
+
+static int32_t tileflatsize(short tilenume)
+{
+    int32_t w, h;
+
+    if (!(flatpic[tilenume>>3]&pow2char[tilenume&7]))
+        return 0;
+
+    w = tiles[tilenume].dim.width;
+    h = tiles[tilenume].dim.height;
+    if ((pow2long[picsiz[tilenume]&15] != w) || (pow2long[picsiz[tilenume]>>4] != h))
+        return 0;
+    if ((w < 8) || (h < 8))
+        return 0;
+    return w*h;
+}
+
+uint8_t* tileflat(short tilenume)
+{
+    return tilemip(tilenume,tiles[tilenume].mips+1);
+}
+
+static void buildtileflat(short tilenume)
+{
+    uint8_t  *src, *dst;
+    int32_t x, y, h, ybits;
+
+    src = tiles[tilenume].data;
+    dst = tileflat(tilenume);
+    h = tiles[tilenume].dim.height;
+    ybits = picsiz[tilenume]>>4;
+
+    for(x=0; x<tiles[tilenume].dim.width; x++)
+        for(y=0; y<h; y++)
+            dst[FLATSWIZZLE((x<<ybits)|y,ybits)] = *src++;
+}
+
 void loadtile(short tilenume)
 {
     uint8_t  *ptr;
-    int32_t i, tileFilesize;
+    int32_t i, l, tileFilesize, mipsize, flatsize;
     
     
     
@@ -146,8 +324,17 @@ void loadtile(short tilenume)
     }
     
     if (tiles[tilenume].data == NULL){
+        //Reserve room for the levels only when the block is allocated: a
+        //reload into an existing block keeps whatever that block has.
+        tiles[tilenume].mips = mipmaps ? tilemiplevels(tilenume) : 0;
+        mipsize = 0;
+        for(l=1; l<=tiles[tilenume].mips; l++)
+            mipsize += (tiles[tilenume].dim.width>>l)*(tiles[tilenume].dim.height>>l);
+        flatsize = swizzleflats ? tileflatsize(tilenume) : 0;
+        tiles[tilenume].flat = (flatsize != 0);
+
         tiles[tilenume].lock = 199;
-        allocache(&tiles[tilenume].data,tileFilesize,(uint8_t  *) &tiles[tilenume].lock);
+        allocache(&tiles[tilenume].data,tileFilesize+mipsize+flatsize,(uint8_t  *) &tiles[tilenume].lock);
     }
     
     if (artfilplc != tilefileoffs[tilenume])
@@ -159,6 +346,11 @@ void loadtile(short tilenume)
     
     kread(artfil,ptr,tileFilesize);
     faketimerhandler();
+
+    if (tiles[tilenume].mips)
+        buildtilemips(tilenume);
+    if (tiles[tilenume].flat)
+        buildtileflat(tilenume);
     artfilplc = tilefileoffs[tilenume]+tileFilesize;
 }
 
@@ -176,6 +368,8 @@ uint8_t* allocatepermanenttile(short tilenume, int32_t width, int32_t height)
     tileDataSize = width * height;
     
     tiles[tilenume].lock = 255;
+    tiles[tilenume].mips = 0;
+    tiles[tilenume].flat = 0;
     allocache(&tiles[tilenume].data,tileDataSize,(uint8_t  *) &tiles[tilenume].lock);
     
     tiles[tilenume].dim.width = width;
@@ -333,6 +527,8 @@ void copytilepiece(int32_t tilenume1, int32_t sx1, int32_t sy1, int32_t xsiz, in
     {
         TILE_MakeAvailable(tilenume1);
         TILE_MakeAvailable(tilenume2);
+        tiles[tilenume2].mips = 0; //Written below: the levels would be stale.
+        tiles[tilenume2].flat = 0;
         
         x1 = sx1;
         for(i=0; i<xsiz; i++)
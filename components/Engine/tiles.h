@@ -39,17 +39,28 @@ typedef struct dimensions_s{
 typedef struct tile_s{
     dimensions_t dim;
     uint8_t lock;
+    uint8_t mips;       // Number of half-size levels stored after data (see tilemip)
+    uint8_t flat;       // Nonzero if a block-swizzled copy follows the levels (see tileflat)
     int32_t animFlags;
     uint8_t* data;
 } tile_t;
 
+#define MAXMIPLEVELS 2
+
+//Offset of column-major texel index i (ybits = log2 height) in the 8x8
+//block layout of tileflat: blocks column-major, texels column-major inside.
+#define FLATSWIZZLE(i,ybits) (((i)&~((8<<(ybits))-1)) | (((i)&((1<<(ybits))-8))<<3) | ((((i)>>(ybits))&7)<<3) | ((i)&7))
+
 extern tile_t *tiles;//[MAXTILES];
 
 
 void setviewtotile(short tilenume, int32_t tileWidth, int32_t tileHeight);
 void squarerotatetile(short tilenume);
+void transposesquare(uint8_t  *buf, int32_t siz);
 
 void loadtile(short tilenume);
+uint8_t* tilemip(short tilenume, int32_t level);
+uint8_t* tileflat(short tilenume);
 uint8_t* allocatepermanenttile(short tilenume, int32_t width, int32_t height);
 int loadpics(char  *filename, char * gamedir);
 void copytilepiece(int32_t tilenume1, int32_t sx1, int32_t sy1, int32_t xsiz, int32_t ysiz,int32_t tilenume2, int32_t sx2, int32_t sy2);
@@ -59,6 +70,10 @@ void copytilepiece(int32_t tilenume1, int32_t sx1, int32_t sy1, int32_t xsiz, in
 extern EXT_RAM_ATTR uint8_t  gotpic[(MAXTILES+7)>>3];
 void setgotpic(int32_t tilenume);
 
+//Bitvector marking pictures used as floors or ceilings (see tileflat).
+extern EXT_RAM_ATTR uint8_t  flatpic[(MAXTILES+7)>>3];
+void setflatpic(int32_t tilenume);
+
 
 
 int animateoffs(int16_t tilenum);
@@ -29,6 +29,22 @@ Prepared for public release: 03/21/2003 - Charlie Wiederhold, 3D Realms
 extern int32_t numenvsnds;
 uint8_t  actor_tog;
 
+/*
+ Lighting effectors (cyclers, SE 3/4/12) re-apply the same shade and pal to
+ every wall and plane of their sector each tic. Most tics the level has not
+ changed, so only store when it has: the map arrays live in PSRAM and an
+ unchanged read leaves the cache line clean.
+*/
+static __inline void setlightshade(int8_t *dst, int32_t shade)
+{
+    if (*dst != (int8_t)shade) *dst = (int8_t)shade;
+}
+
+static __inline void setlightpal(uint8_t  *dst, int32_t pal)
+{
+    if (*dst != (uint8_t)pal) *dst = (uint8_t)pal;
+}
+
 void updateinterpolations()  //Stick at beginning of domovethings
 {
 	int32_t i;
@@ -638,6 +654,7 @@ IRAM_ATTR int movesprite(short spritenum, int32_t xchange, int32_t ychange, int3
         sprite[spritenum].z += (zchange*TICSPERFRAME)>>2;
         if(bg)
             setsprite(spritenum,sprite[spritenum].x,sprite[spritenum].y,sprite[spritenum].z);
+        else touchsector(sprite[spritenum].sectnum,0);
         return 0;
     }
 
@@ -690,7 +707,7 @@ IRAM_ATTR int movesprite(short spritenum, int32_t xchange, int32_t ychange, int3
     {
         if(sprite[spritenum].statnum == 4)
             retval =
-                clipmove(&sprite[spritenum].x,&sprite[spritenum].y,&daz,&dasectnum,((xchange*TICSPERFRAME)<<11),((ychange*TICSPERFRAME)<<11),8L,(4<<8),(4<<8),cliptype);
+                clipmoveprojectile(&sprite[spritenum].x,&sprite[spritenum].y,&daz,&dasectnum,((xchange*TICSPERFRAME)<<11),((ychange*TICSPERFRAME)<<11),8L,(4<<8),(4<<8),cliptype);
         else
             retval =
                 clipmove(&sprite[spritenum].x,&sprite[spritenum].y,&daz,&dasectnum,((xchange*TICSPERFRAME)<<11),((ychange*TICSPERFRAME)<<11),(int32_t)(sprite[spritenum].clipdist<<2),(4<<8),(4<<8),cliptype);
@@ -700,6 +717,7 @@ IRAM_ATTR int movesprite(short spritenum, int32_t xchange, int32_t ychange, int3
         if ( (dasectnum != sprite[spritenum].sectnum) )
             changespritesect(spritenum,dasectnum);
     daz = sprite[spritenum].z + ((zchange*TICSPERFRAME)>>3);
+    touchsector(sprite[spritenum].sectnum,0);
     if ((daz > hittype[spritenum].ceilingz) && (daz <= hittype[spritenum].floorz))
         sprite[spritenum].z = daz;
     else
@@ -1119,13 +1137,14 @@ void movecyclers(void)
             for(x = sector[s].wallnum;x>0;x--,wal++)
                 if( wal->hitag != 1 )
             {
-                wal->shade = j;
+                setlightshade(&wal->shade,j);
 
                 if( (wal->cstat&2) && wal->nextwall >= 0)
-                    wall[wal->nextwall].shade = j;
+                    setlightshade(&wall[wal->nextwall].shade,j);
 
             }
-            sector[s].floorshade = sector[s].ceilingshade = j;
+            setlightshade(&sector[s].floorshade,j);
+            setlightshade(&sector[s].ceilingshade,j);
         }
     }
 }
@@ -2297,6 +2316,7 @@ void movestandables(void)
                 if( t[1] == 1 && s->hitag >= 0) //Move the sector floor
                 {
                     x = sector[sect].floorz;
+                    touchsector(sect,1);
 
                     if(t[3] == 1)
                     {
@@ -4947,6 +4967,10 @@ void moveeffectors(void)   //STATNUM 3
 
         t = &hittype[i].temp_data[0];
 
+        // Everything but the pure lighting effects may move geometry or sprites
+        if( st != 3 && st != 4 && st != 12 )
+            touchsector(s->sectnum,1);
+
         switch(st)
         {
             case 0:
@@ -5599,20 +5623,20 @@ void moveeffectors(void)   //STATNUM 3
                 if( (global_random/(sh+1)&31) < 4 && !t[2])
                 {
              //       t[5] = 4+(global_random&7);
-                    sc->ceilingpal = s->owner>>8;
-                    sc->floorpal = s->owner&0xff;
+                    setlightpal(&sc->ceilingpal,s->owner>>8);
+                    setlightpal(&sc->floorpal,s->owner&0xff);
                     t[0] = s->shade + (global_random&15);
                 }
                 else
                 {
              //       t[5] = 4+(global_random&3);
-                    sc->ceilingpal = s->pal;
-                    sc->floorpal = s->pal;
+                    setlightpal(&sc->ceilingpal,s->pal);
+                    setlightpal(&sc->floorpal,s->pal);
                     t[0] = t[3];
                 }
 
-                sc->ceilingshade = t[0];
-                sc->floorshade = t[0];
+                setlightshade(&sc->ceilingshade,t[0]);
+                setlightshade(&sc->floorshade,t[0]);
 
                 wal = &wall[sc->wallptr];
 
@@ -5620,10 +5644,10 @@ void moveeffectors(void)   //STATNUM 3
                 {
                     if( wal->hitag != 1 )
                     {
-                        wal->shade = t[0];
+                        setlightshade(&wal->shade,t[0]);
                         if((wal->cstat&2) && wal->nextwall >= 0)
                         {
-                            wall[wal->nextwall].shade = wal->shade;
+                            setlightshade(&wall[wal->nextwall].shade,wal->shade);
                         }
                     }
                 }
@@ -5636,8 +5660,8 @@ void moveeffectors(void)   //STATNUM 3
                 {
                     t[1] = s->shade + (global_random&15);//Got really bright
                     t[0] = s->shade + (global_random&15);
-                    sc->ceilingpal = s->owner>>8;
-                    sc->floorpal = s->owner&0xff;
+                    setlightpal(&sc->ceilingpal,s->owner>>8);
+                    setlightpal(&sc->floorpal,s->owner&0xff);
                     j = 1;
                 }
                 else
@@ -5645,27 +5669,27 @@ void moveeffectors(void)   //STATNUM 3
                     t[1] = t[2];
                     t[0] = t[3];
 
-                    sc->ceilingpal = s->pal;
-                    sc->floorpal = s->pal;
+                    setlightpal(&sc->ceilingpal,s->pal);
+                    setlightpal(&sc->floorpal,s->pal);
 
                     j = 0;
                 }
 
-                sc->floorshade = t[1];
-                sc->ceilingshade = t[1];
+                setlightshade(&sc->floorshade,t[1]);
+                setlightshade(&sc->ceilingshade,t[1]);
 
                 wal = &wall[sc->wallptr];
 
                 for(x=sc->wallnum;x > 0; x--,wal++)
                 {
-                    if(j) wal->pal = (s->owner&0xff);
-                    else wal->pal = s->pal;
+                    if(j) setlightpal(&wal->pal,s->owner&0xff);
+                    else setlightpal(&wal->pal,s->pal);
 
                     if( wal->hitag != 1 )
                     {
-                        wal->shade = t[0];
+                        setlightshade(&wal->shade,t[0]);
                         if((wal->cstat&2) && wal->nextwall >= 0)
-                            wall[wal->nextwall].shade = wal->shade;
+                            setlightshade(&wall[wal->nextwall].shade,wal->shade);
                     }
                 }
 
@@ -5675,8 +5699,8 @@ void moveeffectors(void)   //STATNUM 3
                     if(sprite[j].cstat&16)
                     {
                         if (sc->ceilingstat&1)
-                            sprite[j].shade = sc->ceilingshade;
-                        else sprite[j].shade = sc->floorshade;
+                            setlightshade(&sprite[j].shade,sc->ceilingshade);
+                        else setlightshade(&sprite[j].shade,sc->floorshade);
                     }
 
                     j = nextspritesect[j];
@@ -5932,19 +5956,19 @@ void moveeffectors(void)   //STATNUM 3
             case 12:
                 if( t[0] == 3 || t[3] == 1 ) //Lights going off
                 {
-                    sc->floorpal = 0;
-                    sc->ceilingpal = 0;
+                    setlightpal(&sc->floorpal,0);
+                    setlightpal(&sc->ceilingpal,0);
 
                     wal = &wall[sc->wallptr];
                     for(j = sc->wallnum;j > 0; j--, wal++)
                         if(wal->hitag != 1)
                         {
-                            wal->shade = t[1];
-                            wal->pal = 0;
+                            setlightshade(&wal->shade,t[1]);
+                            setlightpal(&wal->pal,0);
                         }
 
-                    sc->floorshade = t[1];
-                    sc->ceilingshade = t[2];
+                    setlightshade(&sc->floorshade,t[1]);
+                    setlightshade(&sc->ceilingshade,t[2]);
                     t[0]=0;
 
                     j = headspritesect[SECT];
@@ -5953,8 +5977,8 @@ void moveeffectors(void)   //STATNUM 3
                         if(sprite[j].cstat&16)
                         {
                             if (sc->ceilingstat&1)
-                                sprite[j].shade = sc->ceilingshade;
-                            else sprite[j].shade = sc->floorshade;
+                                setlightshade(&sprite[j].shade,sc->ceilingshade);
+                            else setlightshade(&sprite[j].shade,sc->floorshade);
                         }
                         j = nextspritesect[j];
 
@@ -5988,8 +6012,8 @@ void moveeffectors(void)   //STATNUM 3
                         if(sprite[j].cstat&16)
                         {
                             if (sc->ceilingstat&1)
-                                sprite[j].shade = sc->ceilingshade;
-                            else sprite[j].shade = sc->floorshade;
+                                setlightshade(&sprite[j].shade,sc->ceilingshade);
+                            else setlightshade(&sprite[j].shade,sc->floorshade);
                         }
                         j = nextspritesect[j];
                     }
@@ -6337,6 +6361,7 @@ void moveeffectors(void)   //STATNUM 3
                             {
                                 wall[j].cstat &= (128+32+8+4+2);
                                 wall[j].overpicnum = 0;
+                                touchwall(j);
                                 if(wall[j].nextwall >= 0)
                                 {
                                     wall[wall[j].nextwall].overpicnum = 0;
@@ -7079,6 +7104,7 @@ void moveeffectors(void)   //STATNUM 3
             case 128: //SE to control glass breakage
 
                 wal = &wall[t[2]];
+                touchwall(t[2]);
 
                 if(wal->cstat|32)
                 {
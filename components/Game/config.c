@@ -700,6 +700,11 @@ void CONFIG_ReadSetup( void )
    SCRIPT_GetNumber( scripthandle, "Screen Setup", "ExtScreenSize",&ud.extended_screen_size);
    SCRIPT_GetNumber( scripthandle, "Screen Setup", "Out",&ud.lockout);
    SCRIPT_GetNumber( scripthandle, "Screen Setup", "ShowFPS",&ud.tickrate);
+   SCRIPT_GetNumber( scripthandle, "Screen Setup", "FarClip",(int32_t*)&farclip);
+   SCRIPT_GetNumber( scripthandle, "Screen Setup", "GovernFPS",(int32_t*)&governfps);
+   SCRIPT_GetNumber( scripthandle, "Screen Setup", "GovernFarClip",(int32_t*)&governfarclip);
+   SCRIPT_GetNumber( scripthandle, "Screen Setup", "GovernDetail",(int32_t*)&governdetail);
+   SCRIPT_GetNumber( scripthandle, "Misc", "ProgressiveEntry",(int32_t*)&progressiveentry);
    ud.tickrate &= 1;
    SCRIPT_GetNumber( scripthandle, "Misc", "Executions",&ud.executions);
    ud.executions++;
@@ -866,6 +871,11 @@ void CONFIG_WriteSetup( void )
    SCRIPT_PutNumber( scripthandle, "Screen Setup", "Messages",ud.fta_on,false,false);
    SCRIPT_PutNumber( scripthandle, "Screen Setup", "Out",ud.lockout,false,false);
    SCRIPT_PutNumber( scripthandle, "Screen Setup", "ShowFPS",ud.tickrate&1,false,false);
+   SCRIPT_PutNumber( scripthandle, "Screen Setup", "FarClip",farclip,false,false);
+   SCRIPT_PutNumber( scripthandle, "Screen Setup", "GovernFPS",governfps,false,false);
+   SCRIPT_PutNumber( scripthandle, "Screen Setup", "GovernFarClip",governfarclip,false,false);
+   SCRIPT_PutNumber( scripthandle, "Screen Setup", "GovernDetail",governdetail,false,false);
+   SCRIPT_PutNumber( scripthandle, "Misc", "ProgressiveEntry",progressiveentry,false,false);
    SCRIPT_PutNumber( scripthandle, "Screen Setup", "ScreenWidth",xdim,false,false);
    SCRIPT_PutNumber( scripthandle, "Screen Setup", "ScreenHeight",ydim,false,false);
    SCRIPT_PutNumber( scripthandle, "Screen Setup", "Fullscreen",BFullScreen,false,false);
@@ -54,6 +54,14 @@ void CVARDEFS_Init()
 	
     REGCONVAR("TickRate", " - Changes the tick rate", g_iTickRate, CVARDEFS_DefaultFunction);
     REGCONVAR("TicksPerFrame", " - Changes the ticks per frame", g_iTicksPerFrame, CVARDEFS_DefaultFunction);
+    REGCONVAR("BatchSprites", " - Draw face sprites column by column in batches", batchsprites, CVARDEFS_DefaultFunction);
+    REGCONVAR("Mipmaps", " - Sample distant walls from half-size tile levels (applies to tiles loaded afterwards)", mipmaps, CVARDEFS_DefaultFunction);
+    REGCONVAR("SwizzleFlats", " - Keep a block-ordered copy of floor/ceiling tiles for faster spans (applies to tiles loaded afterwards)", swizzleflats, CVARDEFS_DefaultFunction);
+    REGCONVAR("FarClip", " - Stop drawing sectors beyond this distance, fading out before it (0 = unlimited)", farclip, CVARDEFS_DefaultFunction);
+    REGCONVAR("ProgressiveEntry", " - Start levels once the nearby tiles are loaded and load the rest while playing", progressiveentry, CVARDEFS_DefaultFunction);
+    REGCONVAR("GovernFPS", " - Frame rate the governor holds by lowering view quality (0 = off)", governfps, CVARDEFS_DefaultFunction);
+    REGCONVAR("GovernFarClip", " - Nearest far clip the governor may use (0 = never clip)", governfarclip, CVARDEFS_DefaultFunction);
+    REGCONVAR("GovernDetail", " - Let the governor drop the view to low detail", governdetail, CVARDEFS_DefaultFunction);
 
     REGCONFUNC("Quit", " - Quit game.", CVARDEFS_FunctionQuit);
     REGCONFUNC("Clear", " - Clear the console.", CVARDEFS_FunctionClear);
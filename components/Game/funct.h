@@ -105,6 +105,10 @@ extern void operatemasterswitches(short low);
 //#line "sector.c" 1104
 extern void operateforcefields(short s,short low);
 //#line "sector.c" 1140
+extern void buildwalltagindex(void);
+extern void buildeffectortagindex(void);
+extern void cleareffectortagindex(void);
+extern short findeffectorbytag(short i,short lo1,short lo2,short hitag);
 extern uint8_t  checkhitswitch(short snum,int32_t w,uint8_t  switchtype);
 //#line "sector.c" 1515
 extern void activatebysector(short sect,short j);
@@ -177,6 +181,9 @@ extern uint8_t  getsound(uint16_t num);
 extern void precachenecessarysounds(void );
 //#line "premap.c" 1201
 extern void cacheit(void );
+extern void cacheitprogressive(short sectnum);
+extern void precacheframe(void);
+extern int progressiveentry;
 //#line "premap.c" 1244
 extern void dofrontscreens(void );
 //#line "premap.c" 1285
@@ -395,6 +402,10 @@ extern short EGS(short whatsect,int32_t s_x,int32_t s_y,int32_t s_z,short s_pn,i
 extern uint8_t  wallswitchcheck(short i);
 //#line "game.c" 2588
 extern short spawn(short j,short pn);
+extern void governorframe(int32_t framems, int32_t viewms);
+extern int governfps;
+extern int governfarclip;
+extern int governdetail;
 //#line "game.c" 4181
 extern void animatesprites(int32_t x,int32_t y,short a,int32_t smoothratio);
 //#line "game.c" 4859
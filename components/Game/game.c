@@ -3251,6 +3251,7 @@ static void se40code(int32_t x,int32_t y,int32_t z,int32_t a,int32_t h, int32_t
 }
 
 static int32_t oyrepeat=-1;
+static uint8_t  govlowdetail = 0;   /* Frame-time governor wants the low detail view */
 
 IRAM_ATTR void displayrooms(short snum,int32_t smoothratio)
 {
@@ -3259,6 +3260,7 @@ IRAM_ATTR void displayrooms(short snum,int32_t smoothratio)
     struct player_struct *p;
     int32_t tposx,tposy,i;
     short tang;
+    uint8_t  detail;
 
     p = &ps[snum];
 
@@ -3272,6 +3274,7 @@ IRAM_ATTR void displayrooms(short snum,int32_t smoothratio)
         return;
 
     smoothratio = min(max(smoothratio,0),65536);
+    detail = govlowdetail ? 0 : ud.detail;
 
     visibility = p->visibility;
 
@@ -3320,7 +3323,7 @@ IRAM_ATTR void displayrooms(short snum,int32_t smoothratio)
             
             setviewtotile(MAXTILES-1,100L,160L);
         }
-        else if( ( ud.screen_tilting && p->rotscrnang ) || ud.detail==0 )
+        else if( ( ud.screen_tilting && p->rotscrnang ) || detail==0 )
         {
                 if (ud.screen_tilting) tang = p->rotscrnang; else tang = 0;
 
@@ -3328,13 +3331,13 @@ IRAM_ATTR void displayrooms(short snum,int32_t smoothratio)
                 if (tiles[MAXTILES-2].data == NULL)
                     allocache(&tiles[MAXTILES-2].data,320L*320L,&tiles[MAXTILES-2].lock);
                 if ((tang&1023) == 0)
-                    setviewtotile(MAXTILES-2,200L>>(1-ud.detail),320L>>(1-ud.detail));
+                    setviewtotile(MAXTILES-2,200L>>(1-detail),320L>>(1-detail));
                 else
-                    setviewtotile(MAXTILES-2,320L>>(1-ud.detail),320L>>(1-ud.detail));
+                    setviewtotile(MAXTILES-2,320L>>(1-detail),320L>>(1-detail));
                 if ((tang&1023) == 512)
                 {     //Block off unscreen section of 90ø tilted screen
-                    j = ((320-60)>>(1-ud.detail));
-                    for(i=(60>>(1-ud.detail))-1;i>=0;i--)
+                    j = ((320-60)>>(1-detail));
+                    for(i=(60>>(1-detail))-1;i>=0;i--)
                     {
                         startumost[i] = 1; startumost[i+j] = 1;
                         startdmost[i] = 0; startdmost[i+j] = 0;
@@ -3451,14 +3454,14 @@ IRAM_ATTR void displayrooms(short snum,int32_t smoothratio)
             tiles[MAXTILES-1].lock = 1;
             screencapt = 0;
         }
-        else if( ( ud.screen_tilting && p->rotscrnang) || ud.detail==0 )
+        else if( ( ud.screen_tilting && p->rotscrnang) || detail==0 )
         {
             if (ud.screen_tilting) tang = p->rotscrnang; else tang = 0;
             setviewback();
             tiles[MAXTILES-2].animFlags &= 0xff0000ff;
             i = (tang&511); if (i > 256) i = 512-i;
             i = sintable[i+512]*8 + sintable[i]*5L;
-            if ((1-ud.detail) == 0) i >>= 1;
+            if ((1-detail) == 0) i >>= 1;
             rotatesprite(160<<16,100<<16,i,tang+512,MAXTILES-2,0,0,4+2+64,windowx1,windowy1,windowx2,windowy2);
             tiles[MAXTILES-2].lock = 199;
         }
@@ -3621,35 +3624,202 @@ uint8_t  wallswitchcheck(short i)
     return 0;
 }
 
-/* RP2350 PERF: Limit explosion/smoke effects to prevent slowdown */
+/* RP2350 PERF: Budget explosion/smoke effects to prevent slowdown.
+ * The engine keeps a live count and a spawn-ordered list per effect class.
+ * When a class is full the new effect still spawns; one of the oldest ones
+ * is retired instead, preferring those far from and behind every player. */
 #define MAX_EXPLOSION_SPRITES 24
-static short count_effect_sprites(short picnum)
+#define MIN_EXPLOSION_SPRITES 8
+#define FX_RETIRE_SCAN 4            /* oldest effects considered for retirement */
+#define FX_FRAME_SLOW 50            /* ms: shrink the budget above this average */
+#define FX_FRAME_FAST 36            /* ms: grow it back below this average */
+#define FX_ADAPT_FRAMES 8           /* frames between budget steps */
+static short effectbudget = MAX_EXPLOSION_SPRITES;
+
+/* RP2350 PERF: Frame-time governor.  With GovernFPS set, the frame and view
+ * times are averaged and view quality is traded for frame rate one step at
+ * a time: first the far clip is pulled in from GOV_FARCLIP_START down to
+ * GovernFarClip, then the view drops to low detail if GovernDetail allows
+ * it.  A step down needs GOV_DOWN_FRAMES slow frames in a row and a step
+ * back up GOV_UP_FRAMES fast ones, with a gap between the slow and fast
+ * thresholds, so the settings settle instead of oscillating.  When the view
+ * is under half of a slow frame the game logic is the bottleneck and only
+ * the effect budget is cut. */
+#define GOV_FARCLIP_START 65536
+#define GOV_FARCLIP_MIN 1024
+#define GOV_DOWN_FRAMES 8
+#define GOV_UP_FRAMES 48
+int governfps = 0;
+int governfarclip = 0;
+int governdetail = 0;
+static int32_t govlevel = 0;
+
+static uint8_t  effectclass(short picnum)
 {
-    short count = 0;
-    short i = headspritestat[5];  /* STAT_MISC - explosions and effects */
-    while (i >= 0 && count < MAX_EXPLOSION_SPRITES + 1)
+    switch(picnum)
     {
-        if (sprite[i].picnum == picnum)
-            count++;
-        i = nextspritestat[i];
+        case EXPLOSION2:        return 1;
+        case EXPLOSION2BOT:     return 2;
+        case SMALLSMOKE:        return 3;
+        case BURNING:           return 4;
+        case BURNING2:          return 5;
+        case SHRINKEREXPLOSION: return 6;
+    }
+    return 0;
+}
+
+/* Only uses game state, so the choice is the same on every node and in demos */
+static short retireeffect(uint8_t  cls)
+{
+    short i, k, p, best;
+    int32_t d, pd, bestd, dx, dy;
+
+    best = -1;
+    bestd = -1;
+    for(i=headspritefx[cls],k=0; i>=0 && k<FX_RETIRE_SCAN; i=nextspritefx[i],k++)
+    {
+        d = 0x7fffffff;
+        for(p=connecthead;p>=0;p=connectpoint2[p])
+        {
+            dx = sprite[i].x-ps[p].posx;
+            dy = sprite[i].y-ps[p].posy;
+            pd = FindDistance2D(dx,dy);
+            if( dmulscale14(dx,sintable[(ps[p].ang+512)&2047],dy,sintable[ps[p].ang&2047]) < 0 )
+                pd += 65536;    // Behind this player
+            if(pd < d) d = pd;
+        }
+        d += (FX_RETIRE_SCAN-k)<<8; // Older wins a close call
+
+        if(d > bestd)
+        {
+            bestd = d;
+            best = i;
+        }
+    }
+
+    if(best >= 0)
+    {
+        // moveexplosions deletes zero sized sprites on its next pass
+        sprite[best].xrepeat = sprite[best].yrepeat = 0;
+        setspritefxclass(best,0);
+    }
+    return best;
+}
+
+/* Far clip of governor step k (1 = first), or 0 once past the GovernFarClip
+ * bound.  The bound is raised to GOV_FARCLIP_MIN so the steps stay finite. */
+static int32_t governclip(int32_t k)
+{
+    int32_t c = GOV_FARCLIP_START, lim;
+
+    if(governfarclip <= 0 || k <= 0) return 0;
+    lim = max(governfarclip,GOV_FARCLIP_MIN);
+    while(--k > 0 && c >= lim)
+        c -= c>>2;
+    return (c >= lim) ? c : 0;
+}
+
+static int32_t governfarsteps(void)
+{
+    int32_t n = 0;
+
+    while(governclip(n+1)) n++;
+    return n;
+}
+
+/* Number of governor steps the GovernFarClip and GovernDetail bounds allow */
+static int32_t governsteps(void)
+{
+    return governfarsteps() + (governdetail != 0);
+}
+
+static void governapply(void)
+{
+    int32_t far = governfarsteps();
+
+    govfarclip = governclip(min(govlevel,far));
+    govlowdetail = (governdetail != 0 && govlevel > far);
+}
+
+/* Adapt to the measured frame time; viewms is the part spent in displayrooms.
+ * The view settings may change anywhere, but the effect budget changes game
+ * state, so it must stay fixed in net games and demos. */
+void governorframe(int32_t framems, int32_t viewms)
+{
+    static int32_t avgms = 0, avgview = 0, frames = 0, slowrun = 0, fastrun = 0;
+    int32_t slowms = FX_FRAME_SLOW, fastms = FX_FRAME_FAST, n;
+
+    avgms = ((avgms<<3)-avgms+framems)>>3;
+    avgview = ((avgview<<3)-avgview+viewms)>>3;
+
+    n = (governfps > 0) ? governsteps() : 0;
+    if(govlevel > n)
+    {
+        govlevel = n;
+        governapply();
+    }
+    if(governfps > 0)
+    {
+        slowms = 1100/governfps;    /* 10% over the target frame time */
+        fastms = 750/governfps;     /* 25% under it */
+
+        if(avgms > slowms)
+        {
+            fastrun = 0;
+            if(++slowrun >= GOV_DOWN_FRAMES && (avgview<<1) >= avgms && govlevel < n)
+            {
+                govlevel++;
+                governapply();
+                slowrun = 0;
+            }
+        }
+        else if(avgms < fastms)
+        {
+            slowrun = 0;
+            if(++fastrun >= GOV_UP_FRAMES && govlevel > 0)
+            {
+                govlevel--;
+                governapply();
+                fastrun = 0;
+            }
+        }
+        else slowrun = fastrun = 0;
+    }
+
+    if(ud.multimode > 1 || ud.recstat != 0)
+    {
+        effectbudget = MAX_EXPLOSION_SPRITES;
+        return;
     }
-    return count;
+
+    if(++frames < FX_ADAPT_FRAMES) return;
+    frames = 0;
+
+    if(avgms > slowms && effectbudget > MIN_EXPLOSION_SPRITES)
+        effectbudget--;
+    else if(avgms < fastms && effectbudget < MAX_EXPLOSION_SPRITES)
+        effectbudget++;
 }
 
 int32_t tempwallptr;
 short spawn( short j, short pn )
 {
-    short i, s, startwall, endwall, sect, clostest;
+    short i, s, startwall, endwall, sect, clostest, fxlimit;
     int32_t x, y, d;
     spritetype *sp;
     char text[512];
+    uint8_t  fxclass;
 
-    /* RP2350 PERF: Limit number of explosion/smoke sprites to prevent slowdown */
-    if (pn == EXPLOSION2 || pn == EXPLOSION2BOT || pn == SMALLSMOKE || 
-        pn == BURNING || pn == BURNING2 || pn == SHRINKEREXPLOSION)
+    /* RP2350 PERF: Keep explosion/smoke sprites within budget.  Retiring
+     * deletes sprites, so demos and net games always get the full budget
+     * whatever the frame times did before them. */
+    fxclass = effectclass(pn);
+    if (fxclass)
     {
-        if (count_effect_sprites(pn) >= MAX_EXPLOSION_SPRITES)
-            return -1;  /* Don't spawn more, return invalid sprite */
+        fxlimit = (ud.multimode > 1 || ud.recstat != 0) ? MAX_EXPLOSION_SPRITES : effectbudget;
+        while (spritefxcnt[fxclass] >= fxlimit)
+            if (retireeffect(fxclass) < 0)
+                break;
     }
 
     if(j >= 0)
@@ -4902,6 +5072,7 @@ short spawn( short j, short pn )
                 break;
 
             case SECTOREFFECTOR:
+                if(j >= 0) cleareffectortagindex(); // not in the index
                 sp->yvel = sector[sect].extra;
                 sp->cstat |= 32768;
                 sp->xrepeat = sp->yrepeat = 0;
@@ -4915,12 +5086,8 @@ short spawn( short j, short pn )
                     case 23:// XPTR END
                         if(sp->lotag != 23)
                         {
-                            for(j=0;j<MAXSPRITES;j++)
-                                if(sprite[j].statnum < MAXSTATUS && sprite[j].picnum == SECTOREFFECTOR && ( sprite[j].lotag == 7 || sprite[j].lotag == 23 ) && i != j && sprite[j].hitag == SHT)
-                                {
-                                    OW = j;
-                                    break;
-                                }
+                            j = findeffectorbytag(i,7,23,SHT);
+                            if(j >= 0) OW = j;
                         }
                         else OW = i;
 
@@ -5211,22 +5378,16 @@ short spawn( short j, short pn )
                                 sector[sect].hitag = i;
                             }
 
-                            for(j = 0;j < MAXSPRITES;j++)
+                            j = findeffectorbytag(-1,1,1,sp->hitag);
+                            if(j >= 0)
                             {
-                                if( sprite[j].statnum < MAXSTATUS )
-                                if( sprite[j].picnum == SECTOREFFECTOR &&
-                                    sprite[j].lotag == 1 &&
-                                    sprite[j].hitag == sp->hitag)
+                                if( sp->ang == 512 )
                                 {
-                                    if( sp->ang == 512 )
-                                    {
-                                        sp->x = sprite[j].x;
-                                        sp->y = sprite[j].y;
-                                    }
-                                    break;
+                                    sp->x = sprite[j].x;
+                                    sp->y = sprite[j].y;
                                 }
                             }
-                            if(j == MAXSPRITES)
+                            else
                             {
                                 sprintf(text,"Found lonely Sector Effector (lotag 0) at (%d,%d)\n",sp->x,sp->y);
                                 gameexit(text);
@@ -5440,6 +5601,9 @@ short spawn( short j, short pn )
                 changespritestat(i,6);
                 break;
     }
+
+    if(fxclass && sprite[i].statnum == 5)
+        setspritefxclass(i,fxclass);
     return i;
 }
 
@@ -8202,6 +8366,7 @@ int main(int argc,char  **argv)
 {
     int32_t i, j;
         int32_t filehandle;
+        int32_t lastframeticks = 0, viewticks;
 
 
         uint8_t  kbdKey;
@@ -8394,6 +8559,7 @@ int main(int argc,char  **argv)
     if(numplayers > 1) // if multimode > 1 and numplayer == 1 => fake player mode on
     {
         ud.multimode = numplayers;
+        effectbudget = MAX_EXPLOSION_SPRITES;
         sendlogon();
     }
     else if(boardfilename[0] != 0)
@@ -8660,7 +8826,9 @@ int main(int argc,char  **argv)
         else
             i = 65536;
 
+        viewticks = getticks();
         displayrooms(screenpeek,i);
+        viewticks = getticks()-viewticks;
         displayrest(i);
 
         if(ps[myconnectindex].gm&MODE_DEMO)
@@ -8676,6 +8844,13 @@ int main(int argc,char  **argv)
             	rotatesprite((320-50)<<16,9<<16,65536L,0,BETAVERSION,0,0,2+8+16+128,0,0,xdim-1,ydim-1);
 
         nextpage();
+
+        precacheframe();
+
+        i = getticks();
+        if(lastframeticks)
+            governorframe(i-lastframeticks,viewticks);
+        lastframeticks = i;
     }
 
 #ifdef DUKE3D_RP2350
@@ -8705,6 +8880,7 @@ uint8_t  opendemoread(uint8_t  which_demo) // 0 = mine
         d[4] = '0' + which_demo;
 
     ud.reccnt = 0;
+    effectbudget = MAX_EXPLOSION_SPRITES;
 
      if(which_demo == 1 && firstdemofile[0] != 0)
      {
@@ -8825,6 +9001,7 @@ void opendemowrite(void)
     if(ud.recstat == 2) kclose(recfilep);
 
     ver = BYTEVERSION;
+    effectbudget = MAX_EXPLOSION_SPRITES;
 
 	// Are we loading a TC?
 	if(getGameDir()[0] != '\0'){
@@ -9095,6 +9272,8 @@ int32_t playback(void)
 		getpackets();
         nextpage();
 
+        precacheframe();
+
         if( ps[myconnectindex].gm==MODE_END || ps[myconnectindex].gm==MODE_GAME )
         {
             if(foundemo)
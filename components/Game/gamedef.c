@@ -228,7 +228,7 @@ void getglobalz(short i)
             zr = 4L;
         else zr = 127L;
 
-        getzrange(s->x,s->y,s->z-(FOURSLEIGHT),s->sectnum,&hittype[i].ceilingz,&hz,&hittype[i].floorz,&lz,zr,CLIPMASK0);
+        getzrangesprite(i,s->x,s->y,s->z-(FOURSLEIGHT),s->sectnum,&hittype[i].ceilingz,&hz,&hittype[i].floorz,&lz,zr,CLIPMASK0);
 
         if( (lz&49152) == 49152 && (sprite[lz&(MAXSPRITES-1)].cstat&48) == 0 )
         {
@@ -279,7 +279,7 @@ void makeitfall(short i)
     }
 
     if( ( s->statnum == 1 || s->statnum == 10 || s->statnum == 2 || s->statnum == 6 ) )
-        getzrange(s->x,s->y,s->z-(FOURSLEIGHT),s->sectnum,&hittype[i].ceilingz,&hz,&hittype[i].floorz,&lz,127L,CLIPMASK0);
+        getzrangesprite(i,s->x,s->y,s->z-(FOURSLEIGHT),s->sectnum,&hittype[i].ceilingz,&hz,&hittype[i].floorz,&lz,127L,CLIPMASK0);
     else
     {
         hittype[i].ceilingz = sector[s->sectnum].ceilingz;
@@ -294,6 +294,7 @@ void makeitfall(short i)
             s->zvel += c;
         else s->zvel = 6144;
         s->z += s->zvel;
+        touchsector(s->sectnum,0);
     }
     if( s->z >= hittype[i].floorz-(FOURSLEIGHT) )
     {
@@ -356,6 +356,7 @@ int loadplayer(int8_t spot)
 
          kdfread(&numwalls,2,1,fil);
      kdfread(&wall[0],sizeof(walltype),MAXWALLS,fil);
+     buildwalltagindex();
          kdfread(&numsectors,2,1,fil);
      kdfread(&sector[0],sizeof(sectortype),MAXSECTORS,fil);
          kdfread(&sprite[0],sizeof(spritetype),MAXSPRITES,fil);
@@ -365,6 +366,7 @@ int loadplayer(int8_t spot)
          kdfread(&headspritestat[0],2,MAXSTATUS+1,fil);
          kdfread(&prevspritestat[0],2,MAXSPRITES,fil);
          kdfread(&nextspritestat[0],2,MAXSPRITES,fil);
+         resetzrangecache();
          kdfread(&numcyclers,sizeof(numcyclers),1,fil);
          kdfread(&cyclers[0][0],12,MAXCYCLERS,fil);
      kdfread(ps,sizeof(struct player_struct)*MAXPLAYERS,1,fil);
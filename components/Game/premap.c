@@ -27,11 +27,31 @@ Prepared for public release: 03/21/2003 - Charlie Wiederhold, 3D Realms
 #include "duke3d.h"
 #include "filesystem.h"
 #include "game.h"
+#include "psram_sections.h"
 
 
 extern uint8_t  everyothertime;
 short which_palookup = 9;
 
+/*
+ Progressive level entry: only the HUD tiles and the tiles of the start
+ sector and its neighbours are loaded before the first frame. The rest of
+ what cacheit() would load goes into precachelist, ordered by sector graph
+ distance from the player, and precacheframe() works through it a few ms
+ per frame. Anything needed sooner is still loaded on demand.
+*/
+#define PRECACHE_SOUND    MAXTILES  // precachelist entries >= this are sounds
+#define PRECACHE_NEAR     1         // Sector hops loaded before the first frame
+#define PRECACHE_FRAME_MS 3
+
+int progressiveentry = 0;
+
+static short precachelist[MAXTILES+NUM_SOUNDS] __psram_bss("precachelist");
+static uint8_t precachelisted[(MAXTILES+NUM_SOUNDS+7)>>3] __psram_bss("precachelisted");
+static int32_t precachehead, precachecount;
+static short precachesect[MAXSECTORS] __psram_bss("precachesect");
+static uint8_t precachedepth[MAXSECTORS] __psram_bss("precachedepth");
+
 
 static void tloadtile(short tilenume)
 {
@@ -247,7 +267,7 @@ uint8_t  getsound(uint16_t num)
     soundsiz[num] = l;
 
     if( (ud.level_number == 0 && ud.volume_number == 0 && (num == 189 || num == 232 || num == 99 || num == 233 || num == 17 ) ) ||
-        ( l < 12288 ) )
+        ( l < SOUNDSTREAMSIZE ) )
     {
         Sound[num].lock = 2;
         allocache(&Sound[num].ptr,l,&Sound[num].lock);
@@ -277,47 +297,162 @@ void precachenecessarysounds(void)
 }
 
 
+// Mark the wall, floor, ceiling and sprite tiles of sector i in gotpic
+static void cachesector(short i)
+{
+    short j;
+
+    for(j=sector[i].wallptr;j<sector[i].wallptr+sector[i].wallnum;j++)
+        if( tiles[wall[j].picnum].data == NULL)
+    {
+        if(tiles[wall[j].picnum].data == NULL)
+            tloadtile(wall[j].picnum);
+        if(wall[j].overpicnum >= 0 && tiles[wall[j].overpicnum].data == NULL )
+            tloadtile(wall[j].overpicnum);
+    }
+
+    if( tiles[sector[i].floorpicnum].data == NULL )
+        tloadtile( sector[i].floorpicnum );
+    if( tiles[sector[i].ceilingpicnum].data == NULL )
+    {
+        tloadtile( sector[i].ceilingpicnum );
+        if( tiles[sector[i].ceilingpicnum].data == (uint8_t*)LA)
+        {
+            tloadtile(LA+1);
+            tloadtile(LA+2);
+        }
+    }
+
+    j = headspritesect[i];
+    while(j >= 0)
+    {
+        if(sprite[j].xrepeat != 0 && sprite[j].yrepeat != 0 && (sprite[j].cstat&32768) == 0)
+            if(tiles[sprite[j].picnum].data == NULL)
+                cachespritenum(j);
+        j = nextspritesect[j];
+    }
+}
+
 void cacheit(void)
 {
-    short i,j;
+    short i;
+
+    precachehead = precachecount = 0;
 
     precachenecessarysounds();
 
     cachegoodsprites();
 
-    for(i=0;i<numwalls;i++)
-        if( tiles[wall[i].picnum].data == NULL)
+    for(i=0;i<numsectors;i++)
+        cachesector(i);
+
+}
+
+static void precacheadd(int32_t e)
+{
+    if(precachelisted[e>>3]&(1<<(e&7))) return;
+    precachelisted[e>>3] |= (1<<(e&7));
+    precachelist[precachecount++] = (short)e;
+}
+
+// Move the tiles marked in gotpic to the end of precachelist
+static void precachegotpic(void)
+{
+    int32_t i, j;
+
+    for(i=0;i<(MAXTILES>>3);i++)
+        if(gotpic[i])
     {
-        if(tiles[wall[i].picnum].data == NULL)
-            tloadtile(wall[i].picnum);
-        if(wall[i].overpicnum >= 0 && tiles[wall[i].overpicnum].data == NULL )
-            tloadtile(wall[i].overpicnum);
+        for(j=0;j<8;j++)
+            if( (gotpic[i]&(1<<j)) && tiles[(i<<3)+j].data == NULL )
+                precacheadd((i<<3)+j);
+        gotpic[i] = 0;
     }
+}
 
-    for(i=0;i<numsectors;i++)
+// Queue sector i's tiles, and the ambient sounds of its MUSICANDSFX sprites
+static void precachesector(short i)
+{
+    short j;
+
+    cachesector(i);
+    precachegotpic();
+
+    for(j=headspritesect[i];j>=0;j=nextspritesect[j])
+        if(sprite[j].picnum == MUSICANDSFX && sprite[j].lotag > 0 && sprite[j].lotag < NUM_SOUNDS)
+            precacheadd(PRECACHE_SOUND+sprite[j].lotag);
+}
+
+void cacheitprogressive(short sectnum)
+{
+    int32_t head, tail, i;
+    short s, k;
+
+    precachehead = precachecount = 0;
+    clearbufbyte(precachelisted,sizeof(precachelisted),0L);
+    clearbufbyte(gotpic,sizeof(gotpic),0L);
+
+    // Breadth-first over the red walls from the start sector
+    memset(precachedepth,255,sizeof(precachedepth));
+    head = tail = 0;
+    if(sectnum >= 0 && sectnum < numsectors)
+    {
+        precachesect[tail++] = sectnum;
+        precachedepth[sectnum] = 0;
+    }
+    while(head < tail)
     {
-        if( tiles[sector[i].floorpicnum].data == NULL )
-            tloadtile( sector[i].floorpicnum );
-        if( tiles[sector[i].ceilingpicnum].data == NULL )
+        s = precachesect[head++];
+        for(i=sector[s].wallptr;i<sector[s].wallptr+sector[s].wallnum;i++)
         {
-            tloadtile( sector[i].ceilingpicnum );
-            if( tiles[sector[i].ceilingpicnum].data == (uint8_t*)LA)
+            k = wall[i].nextsector;
+            if(k >= 0 && precachedepth[k] == 255)
             {
-                tloadtile(LA+1);
-                tloadtile(LA+2);
+                precachedepth[k] = min(precachedepth[s]+1,254);
+                precachesect[tail++] = k;
             }
         }
+    }
+
+    // What the first frames will see, loaded now
+    cachegoodsprites();
+    for(i=0;i<tail && precachedepth[precachesect[i]] <= PRECACHE_NEAR;i++)
+        cachesector(precachesect[i]);
+    docacheit();
 
-        j = headspritesect[i];
-        while(j >= 0)
+    // Everything else, nearest first, then sectors not reachable from the start
+    for(;i<tail;i++)
+        precachesector(precachesect[i]);
+    for(i=0;i<numsectors;i++)
+        if(precachedepth[i] == 255)
+            precachesector(i);
+
+    if (FXDevice != NumSoundCards)
+        for(i=0;i<NUM_SOUNDS;i++)
+            if(Sound[i].ptr == 0)
+                precacheadd(PRECACHE_SOUND+i);
+}
+
+// Load deferred precache entries for up to PRECACHE_FRAME_MS
+void precacheframe(void)
+{
+    int32_t start, e;
+
+    if(precachehead >= precachecount) return;
+
+    start = getticks();
+    do
+    {
+        e = precachelist[precachehead++];
+        if(e >= PRECACHE_SOUND)
         {
-            if(sprite[j].xrepeat != 0 && sprite[j].yrepeat != 0 && (sprite[j].cstat&32768) == 0)
-                if(tiles[sprite[j].picnum].data == NULL)
-                    cachespritenum(j);
-            j = nextspritesect[j];
+            if(Sound[e-PRECACHE_SOUND].ptr == 0)
+                getsound(e-PRECACHE_SOUND);
         }
+        else if(tiles[e].data == NULL)
+            loadtile((short)e);
     }
-
+    while(precachehead < precachecount && getticks()-start < PRECACHE_FRAME_MS);
 }
 
 void docacheit(void)
@@ -759,6 +894,9 @@ void prelevel(uint8_t  g)
         i = nexti;
     }
 
+    buildwalltagindex();
+    buildeffectortagindex();
+
     for(i=0;i < MAXSPRITES;i++)
     {
         if(sprite[i].statnum < MAXSTATUS)
@@ -776,6 +914,8 @@ void prelevel(uint8_t  g)
                 spawn(-1,i);
         }
 
+    cleareffectortagindex();
+
     lotaglist = 0;
 
     i = headspritestat[0];
@@ -1555,8 +1695,13 @@ if (!VOLUMEONE)
 
     if(ud.recstat != 2) MUSIC_StopSong();
 
-    cacheit();
-    docacheit();
+    if(progressiveentry)
+        cacheitprogressive(ps[myconnectindex].cursectnum);
+    else
+    {
+        cacheit();
+        docacheit();
+    }
 
     if(ud.recstat != 2)
     {
@@ -25,6 +25,7 @@ Prepared for public release: 03/21/2003 - Charlie Wiederhold, 3D Realms
 //-------------------------------------------------------------------------
 
 #include "duke3d.h"
+#include "psram_sections.h"
 
 // PRIMITIVE
 
@@ -305,6 +306,8 @@ void doanimations(void)
         if (v > 0) { a = min(a+v,animategoal[i]); }
               else { a = max(a+v,animategoal[i]); }
 
+        touchsector(dasect,1);
+
         if( animateptr[i] == &sector[animatesect[i]].floorz)
         {
             for(p=connecthead;p>=0;p=connectpoint2[p])
@@ -375,6 +378,7 @@ int32_t setanimation(short animsect,int32_t *animptr, int32_t thegoal, int32_t t
     if (j == animatecnt) animatecnt++;
 
     setinterpolation(animptr);
+    touchsector(animsect,1);
 
     return(j);
 }
@@ -1141,6 +1145,7 @@ void operateforcefields(short s, short low)
             case BIGFORCE:
 
                 animwall[p].tag = 0;
+                touchwall(i);
 
                 if( wall[i].cstat )
                 {
@@ -1158,6 +1163,78 @@ void operateforcefields(short s, short low)
 }
 
 
+/*
+ Tag index: hash chains, in ascending index order, of the walls by lotag and
+ of the sector effectors by hitag, so partner lookups walk only the
+ candidates instead of every wall or sprite. Every entry is re-checked
+ against the live tag at lookup, so a tag cleared after the build (like
+ operateforcefields does) just falls out of the match. Walk order stays the
+ same as the full scans it replaces, which keeps game logic deterministic.
+*/
+#define TAGHASHSIZ 256
+#define TAGHASH(tag) (((uint16_t)(tag))&(TAGHASHSIZ-1))
+
+static short walltaghead[TAGHASHSIZ], walltagnext[MAXWALLS] __psram_bss("walltagnext");
+static short effectortaghead[TAGHASHSIZ], effectortagnext[MAXSPRITES] __psram_bss("effectortagnext");
+static uint8_t  walltagsvalid, effectortagsvalid;
+
+void buildwalltagindex(void)
+{
+    short i;
+
+    for(i=0;i<TAGHASHSIZ;i++) walltaghead[i] = -1;
+    for(i=numwalls-1;i>=0;i--)
+        if(wall[i].lotag)
+        {
+            walltagnext[i] = walltaghead[TAGHASH(wall[i].lotag)];
+            walltaghead[TAGHASH(wall[i].lotag)] = i;
+        }
+    walltagsvalid = 1;
+}
+
+// Only valid while prelevel spawns the map: effectors are not re-tagged
+// during that window, but may be afterwards.
+void buildeffectortagindex(void)
+{
+    short i;
+
+    for(i=0;i<TAGHASHSIZ;i++) effectortaghead[i] = -1;
+    for(i=MAXSPRITES-1;i>=0;i--)
+        if(sprite[i].statnum < MAXSTATUS && sprite[i].picnum == SECTOREFFECTOR)
+        {
+            effectortagnext[i] = effectortaghead[TAGHASH(sprite[i].hitag)];
+            effectortaghead[TAGHASH(sprite[i].hitag)] = i;
+        }
+    effectortagsvalid = 1;
+}
+
+void cleareffectortagindex(void)
+{
+    effectortagsvalid = 0;
+}
+
+// Lowest numbered live effector other than i with lotag lo1 or lo2 and
+// the given hitag, or -1.
+short findeffectorbytag(short i,short lo1,short lo2,short hitag)
+{
+    short j;
+
+    if(effectortagsvalid)
+    {
+        for(j=effectortaghead[TAGHASH(hitag)];j>=0;j=effectortagnext[j])
+            if(sprite[j].statnum < MAXSTATUS && sprite[j].picnum == SECTOREFFECTOR &&
+               (sprite[j].lotag == lo1 || sprite[j].lotag == lo2) && i != j && sprite[j].hitag == hitag)
+                return j;
+        return -1;
+    }
+
+    for(j=0;j<MAXSPRITES;j++)
+        if(sprite[j].statnum < MAXSTATUS && sprite[j].picnum == SECTOREFFECTOR &&
+           (sprite[j].lotag == lo1 || sprite[j].lotag == lo2) && i != j && sprite[j].hitag == hitag)
+            return j;
+    return -1;
+}
+
 uint8_t  checkhitswitch(short snum,int32_t w,uint8_t  switchtype)
 {
     uint8_t  switchpal;
@@ -1331,7 +1408,9 @@ uint8_t  checkhitswitch(short snum,int32_t w,uint8_t  switchtype)
         i = nextspritestat[i];
     }
 
-    for(i=0;i<numwalls;i++)
+    if(!walltagsvalid) buildwalltagindex();
+
+    for(i=walltaghead[TAGHASH(lotag)];i>=0;i=walltagnext[i])
     {
         x = i;
         if(lotag == wall[x].lotag)
@@ -1585,6 +1664,7 @@ void checkhitwall(short spr,short dawallnum,int32_t x,int32_t y,int32_t z,short
             case EXPLODINGBARREL:
                 lotsofglass(spr,dawallnum,70);
                 wal->cstat &= ~16;
+                touchwall(dawallnum);
                 wal->overpicnum = MIRRORBROKE;
                 spritesound(GLASS_HEAVYBREAK,spr);
                 return;
@@ -1624,6 +1704,7 @@ void checkhitwall(short spr,short dawallnum,int32_t x,int32_t y,int32_t z,short
         case FANSPRITE:
             wal->overpicnum = FANSPRITEBROKE;
             wal->cstat &= 65535-65;
+            touchwall(dawallnum);
             if(wal->nextwall >= 0)
             {
                 wall[wal->nextwall].overpicnum = FANSPRITEBROKE;
@@ -1638,6 +1719,7 @@ void checkhitwall(short spr,short dawallnum,int32_t x,int32_t y,int32_t z,short
             wal->overpicnum=GLASS2;
             lotsofglass(spr,dawallnum,10);
             wal->cstat = 0;
+            touchwall(dawallnum);
 
             if(wal->nextwall >= 0)
                 wall[wal->nextwall].cstat = 0;
@@ -1650,6 +1732,7 @@ void checkhitwall(short spr,short dawallnum,int32_t x,int32_t y,int32_t z,short
             updatesector(x,y,&sn); if( sn < 0 ) return;
             lotsofcolourglass(spr,dawallnum,80);
             wal->cstat = 0;
+            touchwall(dawallnum);
             if(wal->nextwall >= 0)
                 wall[wal->nextwall].cstat = 0;
             spritesound(VENT_BUST,spr);
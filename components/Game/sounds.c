@@ -282,7 +282,10 @@ uint8_t  loadsound(uint16_t num)
     l = kfilelength( fp );
     soundsiz[num] = l;
 
-    Sound[num].lock = 200;
+    // Streamed instances of this sound may already hold counts, keep them
+    if (Sound[num].lock < 200)
+        Sound[num].lock = 200;
+    else Sound[num].lock++;
 
     allocache(&Sound[num].ptr,l,(uint8_t  *)&Sound[num].lock);
     kread( fp, Sound[num].ptr , l);
@@ -290,6 +293,52 @@ uint8_t  loadsound(uint16_t num)
     return 1;
 }
 
+/*
+ Long sounds are played straight from their file: only the VOC header is
+ read here, the sound system pulls the rest in small pieces while it plays
+ and closes the file at the end. Returns the voice, or FX_Ok when the sound
+ is short, not a VOC, or no stream is free; the caller then loads it whole.
+ ang/dist are used for one-shot sounds, vol/left/right for looped ones.
+*/
+#define SOUNDSTREAMHEADER 64
+
+static int streamsound(short num,short pitch,int32_t ang,int32_t dist,int32_t vol,int32_t left,int32_t right)
+{
+    uint8_t  header[SOUNDSTREAMHEADER];
+    int32_t fp, l;
+    int voice;
+
+    fp = TCkopen4load(sounds[num],0);
+    if(fp == -1) return FX_Ok;
+
+    l = kfilelength( fp );
+    if( l < SOUNDSTREAMSIZE || kread( fp, header, SOUNDSTREAMHEADER ) != SOUNDSTREAMHEADER || header[0] != 'C' )
+    {
+        kclose( fp );
+        return FX_Ok;
+    }
+    soundsiz[num] = l;
+
+    if( soundm[num]&1 )
+        voice = FX_PlayLoopedVOCStream( header, SOUNDSTREAMHEADER, l, fp,
+                pitch,vol,left,right,soundpr[num],num);
+    else
+        voice = FX_PlayVOC3DStream( header, SOUNDSTREAMHEADER, l, fp,
+                pitch,ang,dist,soundpr[num],num);
+
+    if( voice <= FX_Ok )
+    {
+        kclose( fp );
+        return voice;
+    }
+
+    // Balance the Sound[num].lock-- done by TestCallBack when the voice ends
+    if (Sound[num].lock < 200)
+        Sound[num].lock = 200;
+    else Sound[num].lock++;
+    return voice;
+}
+
 int xyzsound(short num,short i,int32_t x,int32_t y,int32_t z)
 {
     int32_t sndist, cx, cy, cz, j,k;
@@ -387,7 +436,18 @@ int xyzsound(short num,short i,int32_t x,int32_t y,int32_t z)
         sndang &= 2047;
     }
 
-    if(Sound[num].ptr == 0) { if( loadsound(num) == 0 ) return 0; }
+    if( soundm[num]&16 ) sndist = 0;
+
+    if(sndist < ((255-LOUDESTVOLUME)<<6) )
+        sndist = ((255-LOUDESTVOLUME)<<6);
+
+    if(Sound[num].ptr == 0)
+    {
+        if( (soundm[num]&1) && Sound[num].num > 0 ) return -1;
+        voice = streamsound(num,pitch,sndang>>6,sndist>>6,sndist>>6,sndist>>6,0);
+        if( voice > FX_Ok ) goto started;
+        if( loadsound(num) == 0 ) return 0;
+    }
     else
     {
        if (Sound[num].lock < 200)
@@ -395,11 +455,6 @@ int xyzsound(short num,short i,int32_t x,int32_t y,int32_t z)
        else Sound[num].lock++;
     }
 
-    if( soundm[num]&16 ) sndist = 0;
-
-    if(sndist < ((255-LOUDESTVOLUME)<<6) )
-        sndist = ((255-LOUDESTVOLUME)<<6);
-
     if( soundm[num]&1 )
     {
         uint16_t start;
@@ -428,6 +483,7 @@ int xyzsound(short num,short i,int32_t x,int32_t y,int32_t z)
         }
     }
 
+started:
     if ( voice > FX_Ok )
     {
         SoundOwner[num][Sound[num].num].i = i;
@@ -462,7 +518,11 @@ void sound(short num)
     }
     else pitch = pitchs;
 
-    if(Sound[num].ptr == 0) { if( loadsound(num) == 0 ) return; }
+    if(Sound[num].ptr == 0)
+    {
+        if( streamsound(num,pitch,0,255-LOUDESTVOLUME,LOUDESTVOLUME,LOUDESTVOLUME,LOUDESTVOLUME) > FX_Ok ) return;
+        if( loadsound(num) == 0 ) return;
+    }
     else
     {
        if (Sound[num].lock < 200)
@@ -598,7 +658,8 @@ void pan3dsound(void)
                 }
         }
 
-        if(Sound[j].ptr == 0 && loadsound(j) == 0 ) continue;
+        // Streamed sounds never had a cache copy to restore
+        if(Sound[j].ptr == 0 && soundsiz[j] < SOUNDSTREAMSIZE && loadsound(j) == 0 ) continue;
         if( soundm[j]&16 ) sndist = 0;
 
         if(sndist < ((255-LOUDESTVOLUME)<<6) )
@@ -36,6 +36,10 @@ Prepared for public release: 03/21/2003 - Charlie Wiederhold, 3D Realms
 
 #define HIRESMUSICPATH "tunes"
 
+// Sounds this long or longer are streamed from the GRP while they play
+// instead of being loaded into the cache (and are not precached)
+#define SOUNDSTREAMSIZE 12288
+
 extern int32 FXDevice;
 extern int32 MusicDevice;
 extern int32 FXVolume;
@@ -120,6 +120,12 @@ int FX_PlayVOC3D( uint8_t *ptr, int32_t pitchoffset, int32_t angle, int32_t dist
        int32_t priority, uint32_t callbackval );
 int FX_PlayWAV3D( uint8_t *ptr, int pitchoffset, int angle, int distance,
        int priority, uint32_t callbackval );
+int FX_PlayVOC3DStream( uint8_t *header, uint32_t header_length, uint32_t file_length,
+       int32_t handle, int32_t pitchoffset, int32_t angle, int32_t distance,
+       int32_t priority, uint32_t callbackval );
+int FX_PlayLoopedVOCStream( uint8_t *header, uint32_t header_length, uint32_t file_length,
+       int32_t handle, int32_t pitchoffset, int32_t vol, int32_t left, int32_t right,
+       int32_t priority, uint32_t callbackval );
 int FX_PlayRaw( uint8_t  *ptr, uint32_t length, uint32_t rate,
        int32_t pitchoffset, int32_t vol, int32_t left, int32_t right, int32_t priority,
        uint32_t callbackval );
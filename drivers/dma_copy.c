@@ -0,0 +1,171 @@
+#include "dma_copy.h"
+#include <stdbool.h>
+#include <string.h>
+
+#if !defined(DMACOPY_SOFTWARE) && defined(__has_include)
+#if __has_include("hardware/dma.h")
+#define DMACOPY_HW 1
+#endif
+#endif
+
+// Fences count up from 1; jobs complete in no particular order across
+// channels, so a fence has passed once no older job is still pending.
+static dmacopy_fence_t next_fence = 1;
+
+#ifdef DMACOPY_HW
+
+#include "hardware/dma.h"
+#include "hardware/sync.h"
+
+#define DMACOPY_CHANNELS 2
+#define DMACOPY_QUEUE 16 // Power of two
+
+typedef struct {
+    void *dst;
+    const void *src;
+    size_t n;
+    dmacopy_fence_t fence;
+    bool fill;
+    uint8_t value;
+} dmacopy_job_t;
+
+static int channels[DMACOPY_CHANNELS];
+static int num_channels = 0;
+static dmacopy_fence_t running[DMACOPY_CHANNELS]; // 0 = idle
+static uint32_t fill_word[DMACOPY_CHANNELS];      // memset source, must outlive the job
+
+static dmacopy_job_t queue[DMACOPY_QUEUE];
+static unsigned queue_head = 0, queue_tail = 0;
+
+void dmacopy_init(void) {
+    int i, ch;
+
+    if (num_channels)
+        return;
+    for (i = 0; i < DMACOPY_CHANNELS; i++) {
+        ch = dma_claim_unused_channel(false);
+        if (ch < 0)
+            break;
+        channels[num_channels] = ch;
+        running[num_channels] = 0;
+        num_channels++;
+    }
+}
+
+static void start_job(int slot, const dmacopy_job_t *job) {
+    dma_channel_config cfg = dma_channel_get_default_config(channels[slot]);
+    const void *src = job->src;
+    size_t count = job->n;
+    enum dma_channel_transfer_size size = DMA_SIZE_8;
+
+    if (job->fill) {
+        fill_word[slot] = job->value * 0x01010101u;
+        src = &fill_word[slot];
+    }
+    // Word transfers when everything lines up (src is ignored for fills)
+    if ((((uintptr_t)job->dst | (uintptr_t)job->src | job->n) & 3) == 0) {
+        size = DMA_SIZE_32;
+        count >>= 2;
+    }
+
+    channel_config_set_transfer_data_size(&cfg, size);
+    channel_config_set_read_increment(&cfg, !job->fill);
+    channel_config_set_write_increment(&cfg, true);
+    channel_config_set_dreq(&cfg, DREQ_FORCE);
+
+    running[slot] = job->fence;
+    dma_channel_configure(channels[slot], &cfg, job->dst, src, count, true);
+}
+
+// Retire finished channels and feed them from the queue.
+static void service(void) {
+    int slot;
+
+    for (slot = 0; slot < num_channels; slot++) {
+        if (running[slot] && !dma_channel_is_busy(channels[slot]))
+            running[slot] = 0;
+        if (!running[slot] && queue_head != queue_tail) {
+            start_job(slot, &queue[queue_head & (DMACOPY_QUEUE - 1)]);
+            queue_head++;
+        }
+    }
+}
+
+static dmacopy_fence_t submit(void *dst, const void *src, size_t n, bool fill, uint8_t value) {
+    dmacopy_job_t *job;
+
+    if (n == 0 || num_channels == 0) {
+        if (fill) memset(dst, value, n);
+        else memcpy(dst, src, n);
+        return next_fence++;
+    }
+
+    service();
+    while (queue_tail - queue_head >= DMACOPY_QUEUE) {
+        tight_loop_contents();
+        service();
+    }
+
+    job = &queue[queue_tail & (DMACOPY_QUEUE - 1)];
+    job->dst = dst;
+    job->src = src;
+    job->n = n;
+    job->fill = fill;
+    job->value = value;
+    job->fence = next_fence++;
+    queue_tail++;
+
+    service();
+    return job->fence;
+}
+
+int dmacopy_done(dmacopy_fence_t fence) {
+    int slot;
+    unsigned i;
+
+    service();
+    for (slot = 0; slot < num_channels; slot++)
+        if (running[slot] && running[slot] <= fence)
+            return 0;
+    for (i = queue_head; i != queue_tail; i++)
+        if (queue[i & (DMACOPY_QUEUE - 1)].fence <= fence)
+            return 0;
+    return 1;
+}
+
+#else // Software fallback
+
+void dmacopy_init(void) {
+}
+
+static dmacopy_fence_t submit(void *dst, const void *src, size_t n, bool fill, uint8_t value) {
+    if (fill) memset(dst, value, n);
+    else memcpy(dst, src, n);
+    return next_fence++;
+}
+
+int dmacopy_done(dmacopy_fence_t fence) {
+    (void)fence;
+    return 1;
+}
+
+#define tight_loop_contents()
+
+#endif
+
+dmacopy_fence_t dmacopy_memcpy(void *dst, const void *src, size_t n) {
+    return submit(dst, src, n, false, 0);
+}
+
+dmacopy_fence_t dmacopy_memset(void *dst, uint8_t value, size_t n) {
+    return submit(dst, NULL, n, true, value);
+}
+
+void dmacopy_wait(dmacopy_fence_t fence) {
+    while (!dmacopy_done(fence))
+        tight_loop_contents();
+}
+
+void dmacopy_wait_all(void) {
+    dmacopy_wait(next_fence - 1);
+}
@@ -0,0 +1,31 @@
+#ifndef DMA_COPY_H
+#define DMA_COPY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Asynchronous memcpy/memset on spare DMA channels.
+ *
+ * Each call queues one job and returns a fence; the CPU is free until it
+ * needs the result and calls dmacopy_wait(fence). Jobs start in submission
+ * order on the first free channel. Source and destination must stay valid
+ * and untouched by the CPU until the fence has passed.
+ *
+ * Without DMA hardware (Linux builds, DMACOPY_SOFTWARE, or no free channel
+ * at init) every job runs synchronously with memcpy/memset and its fence is
+ * already passed when the call returns, so callers need no special case.
+ */
+
+typedef uint32_t dmacopy_fence_t;
+
+void dmacopy_init(void);
+
+dmacopy_fence_t dmacopy_memcpy(void *dst, const void *src, size_t n);
+dmacopy_fence_t dmacopy_memset(void *dst, uint8_t value, size_t n);
+
+int dmacopy_done(dmacopy_fence_t fence);    // Non-blocking: has this job finished?
+void dmacopy_wait(dmacopy_fence_t fence);   // Block until this job (and all before it) finished
+void dmacopy_wait_all(void);
+
+#endif
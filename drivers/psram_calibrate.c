@@ -0,0 +1,43 @@
+#include "psram_calibrate.h"
+
+int psram_calibrate(const psram_cal_ops_t *ops, int min_divisor, int rated_divisor,
+                    int max_divisor, psram_cal_result_t *out) {
+    int divisor, rxdelay, run_start, best_start, best_len;
+
+    if (min_divisor < 1)
+        min_divisor = 1;
+
+    for (divisor = min_divisor; divisor <= max_divisor; divisor++) {
+        run_start = -1;
+        best_start = 0;
+        best_len = 0;
+
+        // One extra step past the end closes a window that reaches it
+        for (rxdelay = 0; rxdelay <= PSRAM_CAL_MAX_RXDELAY + 1; rxdelay++) {
+            int pass = 0;
+
+            if (rxdelay <= PSRAM_CAL_MAX_RXDELAY) {
+                ops->apply(ops->ctx, divisor, rxdelay);
+                pass = ops->test(ops->ctx);
+            }
+            if (pass) {
+                if (run_start < 0)
+                    run_start = rxdelay;
+            } else if (run_start >= 0) {
+                if (rxdelay - run_start > best_len) {
+                    best_start = run_start;
+                    best_len = rxdelay - run_start;
+                }
+                run_start = -1;
+            }
+        }
+
+        if (best_len >= (divisor < rated_divisor ? PSRAM_CAL_FAST_WINDOW : PSRAM_CAL_MIN_WINDOW)) {
+            out->divisor = divisor;
+            out->rxdelay = best_start + best_len / 2;
+            out->window = best_len;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,38 @@
+#ifndef PSRAM_CALIBRATE_H
+#define PSRAM_CALIBRATE_H
+
+/*
+ * PSRAM timing sweep, kept free of hardware access so it can run against a
+ * simulated memory on the host. The caller supplies how to apply a QMI
+ * divisor/rxdelay pair and how to test the memory under it.
+ */
+
+#define PSRAM_CAL_MAX_RXDELAY 7 // QMI_M1_TIMING_RXDELAY is 3 bits
+#define PSRAM_CAL_MIN_WINDOW 3  // Passing rxdelays needed around the pick
+#define PSRAM_CAL_FAST_WINDOW 5 // Same, for divisors faster than the rated one
+
+typedef struct {
+    void (*apply)(void *ctx, int divisor, int rxdelay);
+    int (*test)(void *ctx); // 1 = pattern test passed
+    void *ctx;
+} psram_cal_ops_t;
+
+typedef struct {
+    int divisor;
+    int rxdelay;
+    int window; // Width of the passing rxdelay window the pick sits in
+} psram_cal_result_t;
+
+/*
+ * Try divisors from min_divisor up to max_divisor, fastest first. For each,
+ * sweep every rxdelay and take the widest contiguous passing window; the
+ * first divisor whose window is at least PSRAM_CAL_MIN_WINDOW wide wins,
+ * with rxdelay in the middle of the window (rounded towards more delay).
+ * Divisors below rated_divisor run the memory past its rated clock and need
+ * PSRAM_CAL_FAST_WINDOW instead. Returns 0 and leaves *out untouched if
+ * nothing qualifies.
+ */
+int psram_calibrate(const psram_cal_ops_t *ops, int min_divisor, int rated_divisor,
+                    int max_divisor, psram_cal_result_t *out);
+
+#endif
@@ -3,16 +3,159 @@
 #include "hardware/structs/xip_ctrl.h"
 #include "hardware/clocks.h"
 #include "hardware/gpio.h"
+#include "hardware/structs/watchdog.h"
+#include "hardware/regs/addressmap.h"
 #include "pico/stdlib.h"
+#include "psram_calibrate.h"
+#include <stdio.h>
 
 // PSRAM max frequency - set via CMake or use default
 #ifndef PSRAM_MAX_FREQ_MHZ
 #define PSRAM_MAX_FREQ_MHZ 133
 #endif
 
+// Sweep divisor/rxdelay at boot instead of trusting the formula's margin
+#ifndef PSRAM_CALIBRATE
+#define PSRAM_CALIBRATE 1
+#endif
+
+// Fastest PSRAM clock the sweep may try, in percent of PSRAM_MAX_FREQ_MHZ.
+// Divisors past the rating are only kept with a wider passing window.
+#ifndef PSRAM_CAL_OVERCLOCK_PCT
+#define PSRAM_CAL_OVERCLOCK_PCT 130
+#endif
+
+// Last timing picked by calibration, kept in watchdog scratch registers so
+// a soft reset (e.g. back to the MOS2 menu and in again) skips the sweep.
+// scratch[4..7] belong to the bootrom/SDK reboot logic, use 0..2.
+#define PSRAM_CAL_MAGIC 0x50534331u // "PSC1"
+
+static int psram_clock_hz;
+
+static void __no_inline_not_in_flash_func(psram_set_timing)(int clock_hz, int divisor, int rxdelay) {
+    const int clock_period_fs = 1000000000000000ll / clock_hz;
+    
+    const int max_select_val = (125 * 1000000) / clock_period_fs;
+
+    const int min_deselect = (18 * 1000000 + (clock_period_fs - 1)) / clock_period_fs - (divisor + 1) / 2;
+
+    qmi_hw->m[1].timing = 
+        1 << QMI_M1_TIMING_COOLDOWN_LSB | 
+        QMI_M1_TIMING_PAGEBREAK_VALUE_1024 << QMI_M1_TIMING_PAGEBREAK_LSB | 
+        max_select_val << QMI_M1_TIMING_MAX_SELECT_LSB | 
+        min_deselect << QMI_M1_TIMING_MIN_DESELECT_LSB | 
+        rxdelay << QMI_M1_TIMING_RXDELAY_LSB | 
+        divisor << QMI_M1_TIMING_CLKDIV_LSB;
+}
+
+#if PSRAM_CALIBRATE
+// Pattern test on the first 4KB of PSRAM through the uncached alias, so the
+// XIP cache cannot hide a bad read. Nothing lives in PSRAM yet at this point.
+#define PSRAM_TEST_BASE (XIP_NOCACHE_NOALLOC_BASE + 0x01000000)
+#define PSRAM_TEST_WORDS 1024
+
+static int __no_inline_not_in_flash_func(psram_pattern_test)(void *ctx) {
+    static const uint32_t fixed[] = { 0x00000000, 0xffffffff, 0x55555555, 0xaaaaaaaa };
+    volatile uint32_t *mem = (volatile uint32_t *)PSRAM_TEST_BASE;
+    volatile uint8_t *bytes = (volatile uint8_t *)PSRAM_TEST_BASE;
+    uint32_t i, p, x;
+
+    (void)ctx;
+
+    // Solid and alternating patterns, inverted on odd words to toggle every line
+    for (p = 0; p < 4; p++) {
+        for (i = 0; i < PSRAM_TEST_WORDS; i++)
+            mem[i] = fixed[p] ^ ((i & 1) ? 0xffffffff : 0);
+        for (i = 0; i < PSRAM_TEST_WORDS; i++)
+            if (mem[i] != (fixed[p] ^ ((i & 1) ? 0xffffffff : 0)))
+                return 0;
+    }
+
+    // Walking ones
+    for (i = 0; i < 32; i++)
+        mem[i] = 1u << i;
+    for (i = 0; i < 32; i++)
+        if (mem[i] != (1u << i))
+            return 0;
+
+    // Pseudo-random data mixed with the address
+    x = 0x2545f491;
+    for (i = 0; i < PSRAM_TEST_WORDS; i++) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        mem[i] = x ^ i;
+    }
+    x = 0x2545f491;
+    for (i = 0; i < PSRAM_TEST_WORDS; i++) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        if (mem[i] != (x ^ i))
+            return 0;
+    }
+
+    // Byte lanes
+    for (i = 0; i < 256; i++)
+        bytes[i] = (uint8_t)(i * 37);
+    for (i = 0; i < 256; i++)
+        if (bytes[i] != (uint8_t)(i * 37))
+            return 0;
+
+    return 1;
+}
+
+static void psram_cal_apply(void *ctx, int divisor, int rxdelay) {
+    (void)ctx;
+    psram_set_timing(psram_clock_hz, divisor, rxdelay);
+}
+
+// Applies the fastest timing that passes with margin, from
+// PSRAM_CAL_OVERCLOCK_PCT of the rated clock down to the formula's divisor,
+// or keeps the formula's divisor/rxdelay if none does.
+static void psram_calibrate_timing(int divisor, int rxdelay) {
+    const int clock_khz = psram_clock_hz / 1000;
+    const int rated_khz = PSRAM_MAX_FREQ_MHZ * 1000;
+    const int fastest_khz = rated_khz * PSRAM_CAL_OVERCLOCK_PCT / 100;
+    psram_cal_ops_t ops = { psram_cal_apply, psram_pattern_test, NULL };
+    psram_cal_result_t res;
+
+    if (watchdog_hw->scratch[0] == PSRAM_CAL_MAGIC &&
+        watchdog_hw->scratch[1] == (uint32_t)psram_clock_hz) {
+        int saved_divisor = watchdog_hw->scratch[2] & 0xff;
+        int saved_rxdelay = (watchdog_hw->scratch[2] >> 8) & 0xff;
+
+        psram_set_timing(psram_clock_hz, saved_divisor, saved_rxdelay);
+        if (psram_pattern_test(NULL)) {
+            printf("PSRAM: %d MHz, divisor %d rxdelay %d (saved)\n",
+                   psram_clock_hz / saved_divisor / 1000000, saved_divisor, saved_rxdelay);
+            return;
+        }
+    }
+
+    // From the fastest allowed clock down to the formula's divisor, never
+    // slower: if that has no wide enough window either, the formula timing
+    // below is kept as it was
+    if (psram_calibrate(&ops, (clock_khz + fastest_khz - 1) / fastest_khz,
+                        (clock_khz + rated_khz - 1) / rated_khz, divisor, &res)) {
+        psram_set_timing(psram_clock_hz, res.divisor, res.rxdelay);
+        watchdog_hw->scratch[0] = PSRAM_CAL_MAGIC;
+        watchdog_hw->scratch[1] = psram_clock_hz;
+        watchdog_hw->scratch[2] = res.divisor | (res.rxdelay << 8);
+        printf("PSRAM: %d MHz, divisor %d rxdelay %d (calibrated, window %d, formula %d MHz %d/%d)\n",
+               psram_clock_hz / res.divisor / 1000000, res.divisor, res.rxdelay, res.window,
+               psram_clock_hz / divisor / 1000000, divisor, rxdelay);
+        return;
+    }
+
+    psram_set_timing(psram_clock_hz, divisor, rxdelay);
+    watchdog_hw->scratch[0] = 0;
+    printf("PSRAM: calibration failed, %d MHz, divisor %d rxdelay %d\n",
+           psram_clock_hz / divisor / 1000000, divisor, rxdelay);
+}
+#endif
+
 void __no_inline_not_in_flash_func(psram_init)(uint cs_pin) {
     const int clock_hz = clock_get_hz(clk_sys); 
 
+    psram_clock_hz = clock_hz;
+
     gpio_set_function(cs_pin, GPIO_FUNC_XIP_CS1);
 
     qmi_hw->direct_csr = 10 << QMI_DIRECT_CSR_CLKDIV_LSB | 
@@ -37,19 +180,7 @@ void __no_inline_not_in_flash_func(psram_init)(uint cs_pin) {
         rxdelay += 1; 
     }
 
-    const int clock_period_fs = 1000000000000000ll / clock_hz;
-    
-    const int max_select_val = (125 * 1000000) / clock_period_fs;
-
-    const int min_deselect = (18 * 1000000 + (clock_period_fs - 1)) / clock_period_fs - (divisor + 1) / 2;
-
-    qmi_hw->m[1].timing = 
-        1 << QMI_M1_TIMING_COOLDOWN_LSB | 
-        QMI_M1_TIMING_PAGEBREAK_VALUE_1024 << QMI_M1_TIMING_PAGEBREAK_LSB | 
-        max_select_val << QMI_M1_TIMING_MAX_SELECT_LSB | 
-        min_deselect << QMI_M1_TIMING_MIN_DESELECT_LSB | 
-        rxdelay << QMI_M1_TIMING_RXDELAY_LSB | 
-        divisor << QMI_M1_TIMING_CLKDIV_LSB;
+    psram_set_timing(clock_hz, divisor, rxdelay);
 
     qmi_hw->m[1].rfmt =
         QMI_M0_RFMT_PREFIX_WIDTH_VALUE_Q << QMI_M0_RFMT_PREFIX_WIDTH_LSB | 
@@ -75,4 +206,8 @@ void __no_inline_not_in_flash_func(psram_init)(uint cs_pin) {
     qmi_hw->direct_csr = 0;
     
     hw_set_bits(&xip_ctrl_hw->ctrl, XIP_CTRL_WRITABLE_M1_BITS);
+
+#if PSRAM_CALIBRATE
+    psram_calibrate_timing(divisor, rxdelay);
+#endif
 }
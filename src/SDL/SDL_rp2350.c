@@ -15,6 +15,7 @@
 static int sdl_initialized = 0;
 static char error_string[256] = "";
 extern void stdio_fatfs_init(void);
+extern void fatfs_flush_all(void);
 
 // Global FatFs object
 static FATFS fs;
@@ -36,6 +37,8 @@ int SDL_Init(Uint32 flags) {
 }
 
 void SDL_Quit(void) {
+    // Leaving the game: commit demo/save data still held in write-behind
+    fatfs_flush_all();
     sdl_initialized = 0;
 }
 
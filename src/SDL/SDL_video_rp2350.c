@@ -5,12 +5,13 @@
  * Approach (based on Quake port):
  * - vid_buffer: Game renders here (in PSRAM via psram_malloc)
  * - FRAME_BUF: HDMI reads from here (static in SRAM for fast access)
- * - SDL_Flip: memcpy from vid_buffer to FRAME_BUF (PSRAM->SRAM is fast)
+ * - SDL_Flip: copy vid_buffer to FRAME_BUF, split between DMA and the CPU
  */
 #include "SDL.h"
 #include "SDL_video.h"
 #include "HDMI.h"
 #include "psram_allocator.h"
+#include "dma_copy.h"
 #include "pico/stdlib.h"
 #include <stdlib.h>
 #include <string.h>
@@ -230,8 +231,11 @@ int SDL_SetColors(SDL_Surface *surface, SDL_Color *colors, int firstcolor, int n
 int SDL_Flip(SDL_Surface *screen) {
     if (!screen || !vid_buffer) return -1;
     
-    /* Copy from PSRAM render buffer to SRAM display buffer */
-    memcpy(FRAME_BUF, vid_buffer, FRAME_SIZE);
+    /* Copy from PSRAM render buffer to SRAM display buffer: DMA takes the
+       top half while the CPU copies the bottom half */
+    dmacopy_fence_t fence = dmacopy_memcpy(FRAME_BUF, vid_buffer, FRAME_SIZE / 2);
+    memcpy(FRAME_BUF + FRAME_SIZE / 2, vid_buffer + FRAME_SIZE / 2, FRAME_SIZE - FRAME_SIZE / 2);
+    dmacopy_wait(fence);
     
     return 0;
 }
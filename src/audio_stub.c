@@ -8,6 +8,7 @@
 #include "fx_man.h"
 #include "music.h"
 #include "i_picosound.h"
+#include "filesystem.h"
 
 // Debug: Set to 1 to disable sound effects (but keep music)
 #define DISABLE_SOUND_EFFECTS 0
@@ -235,17 +236,10 @@ int FX_PlayLoopedWAV(uint8_t *ptr, int32_t loopstart, int32_t loopend,
 #endif
 }
 
-int FX_PlayVOC3D(uint8_t *ptr, int32_t pitchoffset, int32_t angle, int32_t distance,
-                 int32_t priority, uint32_t callbackval) {
-    if (!FX_Installed || !ptr) return 0;
-    
-#if DISABLE_SOUND_EFFECTS
-    return 0;  // Disabled for debugging
-#else
-    // Duke3D angle is 0-31 (after >>6 from 0-2047)
-    // Duke3D distance is 0-255 (after >>6 from 0-16383)
-    // angle 0 = front, 8 = right, 16 = back, 24 = left
-    
+// Duke3D angle is 0-31 (after >>6 from 0-2047)
+// Duke3D distance is 0-255 (after >>6 from 0-16383)
+// angle 0 = front, 8 = right, 16 = back, 24 = left
+static void voc3d_volumes(int32_t angle, int32_t distance, int *vol_out, int *left_out, int *right_out) {
     // Calculate volume based on distance (0=close/loud, larger=far/quiet)
     int vol = 255 - (distance * 2);  // distance is roughly 0-127 for audible
     if (vol < 32) vol = 32;  // Don't go completely silent
@@ -284,8 +278,20 @@ int FX_PlayVOC3D(uint8_t *ptr, int32_t pitchoffset, int32_t angle, int32_t dista
     if (right < 32) right = 32;
     
     // Apply volume
-    left = (left * vol) / 255;
-    right = (right * vol) / 255;
+    *vol_out = vol;
+    *left_out = (left * vol) / 255;
+    *right_out = (right * vol) / 255;
+}
+
+int FX_PlayVOC3D(uint8_t *ptr, int32_t pitchoffset, int32_t angle, int32_t distance,
+                 int32_t priority, uint32_t callbackval) {
+    if (!FX_Installed || !ptr) return 0;
+    
+#if DISABLE_SOUND_EFFECTS
+    return 0;  // Disabled for debugging
+#else
+    int vol, left, right;
+    voc3d_volumes(angle, distance, &vol, &left, &right);
     
     uint32_t length = get_voc_data_length(ptr);
     
@@ -294,6 +300,62 @@ int FX_PlayVOC3D(uint8_t *ptr, int32_t pitchoffset, int32_t angle, int32_t dista
 #endif
 }
 
+// Streamed VOCs read the rest of their file through its kopen4load handle
+static int32_t stream_read(void *ctx, uint8_t *dst, int32_t len) {
+    return kread((int32_t)(intptr_t)ctx, dst, len);
+}
+
+static void stream_seek(void *ctx, uint32_t pos) {
+    klseek((int32_t)(intptr_t)ctx, (int32_t)pos, SEEK_SET);
+}
+
+static void stream_close(void *ctx) {
+    kclose((int32_t)(intptr_t)ctx);
+}
+
+static int play_voc_stream(uint8_t *header, uint32_t header_length, uint32_t file_length,
+                           int32_t handle, int32_t pitchoffset, int vol, int left, int right,
+                           int32_t priority, uint32_t callbackval, bool looping) {
+    sound_stream_t stream;
+    
+    stream.read = stream_read;
+    stream.seek = stream_seek;
+    stream.close = stream_close;
+    stream.ctx = (void *)(intptr_t)handle;
+    return I_PicoSound_PlayVOCStream(header, header_length, file_length, &stream,
+                                     pitchoffset, vol, left, right,
+                                     priority, callbackval, looping);
+}
+
+int FX_PlayVOC3DStream(uint8_t *header, uint32_t header_length, uint32_t file_length,
+                       int32_t handle, int32_t pitchoffset, int32_t angle, int32_t distance,
+                       int32_t priority, uint32_t callbackval) {
+    if (!FX_Installed || !header) return 0;
+    
+#if DISABLE_SOUND_EFFECTS
+    return 0;  // Disabled for debugging
+#else
+    int vol, left, right;
+    voc3d_volumes(angle, distance, &vol, &left, &right);
+    
+    return play_voc_stream(header, header_length, file_length, handle, pitchoffset,
+                           vol, left, right, priority, callbackval, false);
+#endif
+}
+
+int FX_PlayLoopedVOCStream(uint8_t *header, uint32_t header_length, uint32_t file_length,
+                           int32_t handle, int32_t pitchoffset, int32_t vol, int32_t left,
+                           int32_t right, int32_t priority, uint32_t callbackval) {
+    if (!FX_Installed || !header) return 0;
+    
+#if DISABLE_SOUND_EFFECTS
+    return 0;  // Disabled for debugging
+#else
+    return play_voc_stream(header, header_length, file_length, handle, pitchoffset,
+                           vol, left, right, priority, callbackval, true);
+#endif
+}
+
 int FX_PlayWAV3D(uint8_t *ptr, int pitchoffset, int angle, int distance,
                  int priority, uint32_t callbackval) {
     if (!FX_Installed || !ptr) return 0;
@@ -302,35 +364,8 @@ int FX_PlayWAV3D(uint8_t *ptr, int pitchoffset, int angle, int distance,
     return 0;  // Disabled for debugging
 #else
     // Same calculation as VOC3D - Duke3D angle is 0-31
-    int vol = 255 - (distance * 2);
-    if (vol < 32) vol = 32;
-    if (vol > 255) vol = 255;
-    
-    int left = 128;
-    int right = 128;
-    int scaled_angle = (angle * 8) & 255;
-    
-    if (scaled_angle < 64) {
-        right = 128 + scaled_angle * 2;
-        left = 256 - right;
-    } else if (scaled_angle < 128) {
-        right = 128 + (128 - scaled_angle) * 2;
-        left = 256 - right;
-    } else if (scaled_angle < 192) {
-        left = 128 + (scaled_angle - 128) * 2;
-        right = 256 - left;
-    } else {
-        left = 128 + (256 - scaled_angle) * 2;
-        right = 256 - left;
-    }
-    
-    if (left > 255) left = 255;
-    if (right > 255) right = 255;
-    if (left < 32) left = 32;
-    if (right < 32) right = 32;
-    
-    left = (left * vol) / 255;
-    right = (right * vol) / 255;
+    int vol, left, right;
+    voc3d_volumes(angle, distance, &vol, &left, &right);
     
     uint32_t length = get_wav_data_length(ptr);
     return I_PicoSound_PlayWAV(ptr, length, pitchoffset, vol, left, right,
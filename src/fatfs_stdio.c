@@ -6,23 +6,40 @@
 #include <stdio.h>
 #include <errno.h>
 #include <string.h>
+#include <strings.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include "psram_sections.h"
 
 // Map FILE*/int fd to FIL* for FatFS
 #define MAX_OPEN_FILES 16
 #define FD_OFFSET 10  // Start file descriptors above stdin/stdout/stderr
 
 typedef struct {
-    FIL fil;
+    FIL fil;       // Must stay first: FILE* is the address of fil
     int in_use;
     int is_posix;  // 1 if opened via open(), 0 if via fopen()
+    int write_only; // Opened without read access: writes may be held back
+    int wb;        // Write-behind buffer owned by this handle, -1 if none
 } file_handle_t;
 
 static file_handle_t file_handles[MAX_OPEN_FILES];
 
+// Write-behind: small writes to write-only files (saves, demos, config) are
+// gathered in PSRAM and committed in WB_SIZE chunks that end on WB_SIZE
+// file offsets, so FatFS sees large cluster-aligned sequential writes.
+// Pending data is committed before any read, seek, tell or size query on
+// the handle, and on close.
+#define WB_BUFFERS 2
+#define WB_SIZE (32 * 1024) // Multiple of every FAT cluster size up to 32KB
+
+static uint8_t wb_data[WB_BUFFERS][WB_SIZE] __psram_bss("fatfs_wb");
+static int wb_owner[WB_BUFFERS] = { -1, -1 };
+static UINT wb_fill[WB_BUFFERS];
+static UINT wb_limit[WB_BUFFERS]; // Bytes up to the next WB_SIZE file offset
+
 // Find a free file handle
 static int find_free_handle(void) {
     for (int i = 0; i < MAX_OPEN_FILES; i++) {
@@ -50,6 +67,218 @@ static int fd_to_handle(int fd) {
     return -1;
 }
 
+// Convert FIL* to handle index
+static int fil_to_handle(FIL *fil) {
+    int idx = (int)((file_handle_t *)fil - file_handles);
+    if (idx >= 0 && idx < MAX_OPEN_FILES && file_handles[idx].in_use) {
+        return idx;
+    }
+    return -1;
+}
+
+// Commit and release the handle's write-behind buffer, if it has one
+static FRESULT wb_flush(int idx) {
+    int b;
+    UINT bw;
+    FRESULT fr = FR_OK;
+
+    if (idx < 0 || (b = file_handles[idx].wb) < 0) return FR_OK;
+
+    if (wb_fill[b] > 0) {
+        fr = f_write(&file_handles[idx].fil, wb_data[b], wb_fill[b], &bw);
+        if (fr == FR_OK && bw != wb_fill[b]) fr = FR_DENIED; // Disk full
+    }
+    wb_owner[b] = -1;
+    file_handles[idx].wb = -1;
+    return fr;
+}
+
+// Commit every pending write-behind buffer
+void fatfs_flush_all(void) {
+    for (int b = 0; b < WB_BUFFERS; b++) {
+        if (wb_owner[b] >= 0) wb_flush(wb_owner[b]);
+    }
+}
+
+// Write through the handle's write-behind buffer; *written counts bytes accepted
+static FRESULT wb_write(int idx, const void *buf, UINT count, UINT *written) {
+    file_handle_t *h = &file_handles[idx];
+    const uint8_t *src = (const uint8_t *)buf;
+    UINT n, bw;
+    FRESULT fr;
+    int b;
+
+    *written = 0;
+    b = h->wb;
+    if (b < 0 && h->write_only && count < WB_SIZE) {
+        for (b = 0; b < WB_BUFFERS && wb_owner[b] >= 0; b++);
+        if (b < WB_BUFFERS) {
+            wb_owner[b] = idx;
+            wb_fill[b] = 0;
+            wb_limit[b] = WB_SIZE - (UINT)(f_tell(&h->fil) % WB_SIZE);
+            h->wb = b;
+        } else {
+            b = -1;
+        }
+    }
+    if (b < 0) {
+        return f_write(&h->fil, buf, count, written);
+    }
+
+    while (count > 0) {
+        // Whole aligned chunks skip the copy
+        if (wb_fill[b] == 0 && wb_limit[b] == WB_SIZE && count >= WB_SIZE) {
+            n = count - count % WB_SIZE;
+            fr = f_write(&h->fil, src, n, &bw);
+            *written += bw;
+            if (fr != FR_OK || bw != n) return (fr != FR_OK) ? fr : FR_DENIED;
+            src += n;
+            count -= n;
+            continue;
+        }
+
+        n = wb_limit[b] - wb_fill[b];
+        if (n > count) n = count;
+        memcpy(wb_data[b] + wb_fill[b], src, n);
+        wb_fill[b] += n;
+        *written += n;
+        src += n;
+        count -= n;
+
+        if (wb_fill[b] == wb_limit[b]) {
+            fr = f_write(&h->fil, wb_data[b], wb_fill[b], &bw);
+            if (fr != FR_OK || bw != wb_fill[b]) {
+                wb_fill[b] = 0;
+                return (fr != FR_OK) ? fr : FR_DENIED;
+            }
+            wb_fill[b] = 0;
+            wb_limit[b] = WB_SIZE;
+        }
+    }
+    return FR_OK;
+}
+
+// Warm file: while the welcome menu is idle it opens the GRP it expects to
+// be chosen, builds the FatFS cluster link map so seeks stop walking the
+// FAT, and copies the first reads the engine will make into PSRAM. A later
+// read-only open() of the same path takes over the handle. Reads that fall
+// entirely inside a cached extent are served from PSRAM, and SEEK_SET is
+// applied lazily so a cache hit never touches the card.
+#define WARM_SIZE (256 * 1024)
+#define WARM_EXTENTS 48
+#define WARM_CLMT_SIZE 64 // DWORDs, enough for 31 fragments
+
+typedef struct {
+    FSIZE_t start;
+    UINT len;
+    UINT at;       // Offset in warm_data
+} warm_extent_t;
+
+static uint8_t warm_data[WARM_SIZE] __psram_bss("fatfs_warm");
+static warm_extent_t warm_ext[WARM_EXTENTS];
+static int warm_count;
+static UINT warm_fill;
+static DWORD warm_clmt[WARM_CLMT_SIZE];
+static char warm_path[64];
+static int warm_idx = -1;      // Handle holding the warm file, -1 if none
+static int warm_adopted;       // Handed out by open()
+static FSIZE_t warm_pos;       // Position of the adopted handle
+static int warm_seek_pending;  // warm_pos not applied to the FIL yet
+
+// Apply a deferred seek before the FIL itself is used
+static FRESULT warm_sync(int idx) {
+    if (idx != warm_idx || !warm_seek_pending) return FR_OK;
+    warm_seek_pending = 0;
+    return f_lseek(&file_handles[idx].fil, warm_pos);
+}
+
+// Cached extent holding all of [pos, pos + count), or NULL
+static const warm_extent_t *warm_find(FSIZE_t pos, size_t count) {
+    for (int i = 0; i < warm_count; i++) {
+        const warm_extent_t *e = &warm_ext[i];
+        if (pos >= e->start && pos + count <= e->start + e->len) return e;
+    }
+    return NULL;
+}
+
+// Forget the warm file; closes it unless open() has handed it out
+void fatfs_warm_cancel(void) {
+    if (warm_idx >= 0) {
+        FIL *fil = &file_handles[warm_idx].fil;
+        if (warm_adopted) {
+            warm_sync(warm_idx);
+            fil->cltbl = 0;  // warm_clmt is about to be reused
+        } else {
+            f_close(fil);
+            file_handles[warm_idx].in_use = 0;
+        }
+    }
+    warm_idx = -1;
+    warm_adopted = 0;
+    warm_seek_pending = 0;
+    warm_count = 0;
+    warm_fill = 0;
+    warm_path[0] = '\0';
+}
+
+// Open path as the warm file, replacing any previous one
+int fatfs_warm_begin(const char *path) {
+    FIL *fil;
+    int idx;
+
+    fatfs_warm_cancel();
+    if (strlen(path) >= sizeof(warm_path)) return -1;
+    idx = find_free_handle();
+    if (idx < 0) return -1;
+
+    fil = &file_handles[idx].fil;
+    if (f_open(fil, path, FA_READ) != FR_OK) return -1;
+    file_handles[idx].in_use = 1;
+    file_handles[idx].is_posix = 1;
+    file_handles[idx].write_only = 0;
+    file_handles[idx].wb = -1;
+
+    // A file too fragmented for the table just seeks the slow way
+    warm_clmt[0] = WARM_CLMT_SIZE;
+    fil->cltbl = warm_clmt;
+    if (f_lseek(fil, CREATE_LINKMAP) != FR_OK) fil->cltbl = 0;
+
+    strcpy(warm_path, path);
+    warm_idx = idx;
+    return 0;
+}
+
+// Read len bytes at offset of the warm file into the cache. Returns the
+// cached copy, or NULL if there is no warm file, it was handed out, the
+// cache is full or the read failed.
+const void *fatfs_warm_read(FSIZE_t offset, UINT len) {
+    warm_extent_t *e = warm_count > 0 ? &warm_ext[warm_count - 1] : NULL;
+    FIL *fil;
+    UINT br;
+
+    if (warm_idx < 0 || warm_adopted || len > WARM_SIZE - warm_fill) return NULL;
+    // Contiguous reads grow the last extent
+    if (!e || e->start + e->len != offset || e->at + e->len != warm_fill) {
+        if (warm_count == WARM_EXTENTS) return NULL;
+        e = NULL;
+    }
+
+    fil = &file_handles[warm_idx].fil;
+    if (f_lseek(fil, offset) != FR_OK) return NULL;
+    if (f_read(fil, warm_data + warm_fill, len, &br) != FR_OK || br != len) return NULL;
+
+    if (e) {
+        e->len += len;
+    } else {
+        e = &warm_ext[warm_count++];
+        e->start = offset;
+        e->len = len;
+        e->at = warm_fill;
+    }
+    warm_fill += len;
+    return warm_data + warm_fill - len;
+}
+
 // ============= POSIX Functions (open, close, read, write, lseek) =============
 
 int __wrap_open(const char *pathname, int flags, ...) {
@@ -57,6 +286,15 @@ int __wrap_open(const char *pathname, int flags, ...) {
     FRESULT fr;
     int idx;
     
+    // Take over the handle the welcome menu warmed for this file
+    if (warm_idx >= 0 && !warm_adopted && (flags & O_ACCMODE) == O_RDONLY &&
+        strcasecmp(pathname, warm_path) == 0) {
+        warm_adopted = 1;
+        warm_pos = 0;
+        warm_seek_pending = 1;
+        return warm_idx + FD_OFFSET;
+    }
+    
     idx = find_free_handle();
     if (idx < 0) {
         errno = ENOMEM;
@@ -100,20 +338,34 @@ int __wrap_open(const char *pathname, int flags, ...) {
     
     file_handles[idx].in_use = 1;
     file_handles[idx].is_posix = 1;
+    file_handles[idx].write_only = !(fatfs_mode & FA_READ);
+    file_handles[idx].wb = -1;
     
     return idx + FD_OFFSET;
 }
 
 int __wrap_close(int fd) {
     int idx = fd_to_handle(fd);
+    FRESULT fr;
     
     if (idx < 0) {
         errno = EBADF;
         return -1;
     }
     
-    f_close(&file_handles[idx].fil);
+    if (idx == warm_idx) {
+        warm_adopted = 0;
+        fatfs_warm_cancel();
+        return 0;
+    }
+    
+    fr = wb_flush(idx);
+    if (f_close(&file_handles[idx].fil) != FR_OK) fr = FR_DISK_ERR;
     file_handles[idx].in_use = 0;
+    if (fr != FR_OK) {
+        errno = EIO;
+        return -1;
+    }
     return 0;
 }
 
@@ -128,6 +380,23 @@ ssize_t __wrap_read(int fd, void *buf, size_t count) {
         return -1;
     }
     
+    if (idx == warm_idx && warm_adopted) {
+        FIL *fil = &file_handles[idx].fil;
+        FSIZE_t pos = warm_seek_pending ? warm_pos : f_tell(fil);
+        const warm_extent_t *e = warm_find(pos, count);
+        if (e) {
+            memcpy(buf, warm_data + e->at + (UINT)(pos - e->start), count);
+            warm_pos = pos + count;
+            warm_seek_pending = 1;
+            return (ssize_t)count;
+        }
+        if (warm_sync(idx) != FR_OK) {
+            errno = EIO;
+            return -1;
+        }
+    }
+    
+    wb_flush(idx);
     fr = f_read(&file_handles[idx].fil, buf, count, &br);
     if (fr != FR_OK) {
         errno = EIO;
@@ -149,7 +418,7 @@ ssize_t __wrap_write(int fd, const void *buf, size_t count) {
         return count;
     }
     
-    fr = f_write(&file_handles[idx].fil, buf, count, &bw);
+    fr = wb_write(idx, buf, count, &bw);
     if (fr != FR_OK) {
         errno = EIO;
         return -1;
@@ -169,6 +438,17 @@ off_t __wrap_lseek(int fd, off_t offset, int whence) {
     
     FIL *fil = &file_handles[idx].fil;
     
+    if (idx == warm_idx && warm_adopted && whence == SEEK_SET && offset >= 0) {
+        warm_pos = offset;
+        warm_seek_pending = 1;
+        return offset;
+    }
+    
+    if (wb_flush(idx) != FR_OK || warm_sync(idx) != FR_OK) {
+        errno = EIO;
+        return (off_t)-1;
+    }
+    
     switch (whence) {
         case SEEK_SET:
             pos = offset;
@@ -196,6 +476,7 @@ off_t __wrap_lseek(int fd, off_t offset, int whence) {
 long filelength(int fd) {
     int idx = fd_to_handle(fd);
     if (idx < 0) return 0;
+    wb_flush(idx);
     return (long)f_size(&file_handles[idx].fil);
 }
 
@@ -232,6 +513,8 @@ FILE *__wrap_fopen(const char *filename, const char *mode) {
     }
     file_handles[idx].in_use = 1;
     file_handles[idx].is_posix = 0;
+    file_handles[idx].write_only = !(fatfs_mode & FA_READ);
+    file_handles[idx].wb = -1;
     return fil_to_file(&file_handles[idx].fil);
 }
 
@@ -240,9 +523,10 @@ int __wrap_fclose(FILE *fp) {
     
     for (int i = 0; i < MAX_OPEN_FILES; i++) {
         if (file_handles[i].in_use && &file_handles[i].fil == fil) {
-            f_close(fil);
+            FRESULT fr = wb_flush(i);
+            if (f_close(fil) != FR_OK) fr = FR_DISK_ERR;
             file_handles[i].in_use = 0;
-            return 0;
+            return (fr == FR_OK) ? 0 : EOF;
         }
     }
     
@@ -254,6 +538,7 @@ size_t __wrap_fread(const void *ptr, size_t size, size_t nmemb, FILE *fp) {
     UINT br;
     FRESULT fr;
     
+    wb_flush(fil_to_handle(fil));
     fr = f_read(fil, (void*)ptr, size * nmemb, &br);
     if (fr != FR_OK) return 0;
     
@@ -266,6 +551,7 @@ int __wrap_fgetc(FILE *fp) {
     FRESULT fr;
     unsigned char c;
     
+    wb_flush(fil_to_handle(fil));
     fr = f_read(fil, &c, 1, &br);
     if (fr != FR_OK || br == 0) return EOF;
     
@@ -274,10 +560,12 @@ int __wrap_fgetc(FILE *fp) {
 
 size_t __wrap_fwrite(const void *ptr, size_t size, size_t nmemb, FILE *fp) {
     FIL *fil = file_to_fil(fp);
+    int idx = fil_to_handle(fil);
     UINT bw;
     FRESULT fr;
     
-    fr = f_write(fil, ptr, size * nmemb, &bw);
+    if (idx < 0 || size == 0) return 0;
+    fr = wb_write(idx, ptr, size * nmemb, &bw);
     if (fr != FR_OK) return 0;
     
     return bw / size;
@@ -287,6 +575,8 @@ int __wrap_fseek(FILE *fp, long offset, int whence) {
     FIL *fil = file_to_fil(fp);
     FSIZE_t pos;
     
+    if (wb_flush(fil_to_handle(fil)) != FR_OK) return -1;
+    
     switch (whence) {
         case SEEK_SET:
             pos = offset;
@@ -306,6 +596,7 @@ int __wrap_fseek(FILE *fp, long offset, int whence) {
 
 long __wrap_ftell(FILE *fp) {
     FIL *fil = file_to_fil(fp);
+    wb_flush(fil_to_handle(fil));
     return (long)f_tell(fil);
 }
 
@@ -327,8 +618,17 @@ int fatfs_mkdir(const char *path) {
 
 // Initialize file handles
 void stdio_fatfs_init(void) {
+    fatfs_flush_all();
     for (int i = 0; i < MAX_OPEN_FILES; i++) {
         file_handles[i].in_use = 0;
         file_handles[i].is_posix = 0;
+        file_handles[i].wb = -1;
+    }
+    for (int b = 0; b < WB_BUFFERS; b++) {
+        wb_owner[b] = -1;
     }
+    warm_idx = -1;
+    warm_adopted = 0;
+    warm_count = 0;
+    warm_fill = 0;
 }
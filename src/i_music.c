@@ -949,6 +949,11 @@ void I_Music_Pause(void) {
     if (!music_playing) return;
     music_paused = true;
 
+    // Take the generator off core1 before touching the OPL from here
+    if (I_PicoSound_IsInitialized()) {
+        I_PicoSound_SetMusicGenerator(NULL);
+    }
+
     // Stop all active notes
     for (int i = 0; i < OPL_NUM_VOICES; i++) {
         if (voices[i].active) {
@@ -960,6 +965,10 @@ void I_Music_Pause(void) {
 
 void I_Music_Resume(void) {
     music_paused = false;
+
+    if (music_playing && I_PicoSound_IsInitialized()) {
+        I_PicoSound_SetMusicGenerator(MusicGenerator);
+    }
 }
 
 bool I_Music_IsPlaying(void) {
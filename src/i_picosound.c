@@ -3,6 +3,16 @@
  * Based on murmdoom's i_picosound implementation
  * Uses I2S audio via PIO
  *
+ * Mixing, ADPCM decoding and the music generator run on core1, which owns
+ * the voice state and the I2S producer pool. The game on core0 only picks
+ * voice slots and hands play/stop/pan requests to core1 through a
+ * single-producer command ring; finished-sound callbacks come back the
+ * other way and are run by I_PicoSound_Update on core0.
+ *
+ * Long sounds can be streamed instead of loaded whole: core0 reads them
+ * from the GRP into a small per-stream ring in I_PicoSound_Update and
+ * core1 decodes straight out of that ring.
+ *
  * Copyright (C) 2024
  * Portions from murmdoom (C) 2021-2022 Graham Sanderson
  */
@@ -13,12 +23,15 @@
 
 #include "i_picosound.h"
 #include "board_config.h"
+#include "psram_sections.h"
 
 #define none pico_audio_enum_none
 #include "pico/audio_i2s.h"
 #undef none
 #include "pico/stdlib.h"
+#include "pico/multicore.h"
 #include "hardware/gpio.h"
+#include "hardware/sync.h"
 
 #ifndef INT16_MAX
 #define INT16_MAX 32767
@@ -72,21 +85,86 @@ typedef struct voice_s {
     int adpcm_step;                // ADPCM step (0-3)
     
     uint32_t callback_val;         // Value to pass to callback
+    int handle;                    // Handle this voice was started with
+    uint8_t stream;                // 1 + index into streams[], 0 = data is in memory
     
 #if SOUND_LOW_PASS
     uint8_t alpha256;              // Low-pass filter coefficient
 #endif
 } voice_t;
 
+// Everything core0 decides about a new voice; core1 copies it into the
+// voice_t and decodes the first block.
+typedef struct {
+    const uint8_t *data;
+    const uint8_t *data_end;
+    const uint8_t *loop_start;
+    const uint8_t *loop_end;
+    uint32_t step;
+    uint32_t callback_val;
+    int handle;
+    uint8_t left_vol;
+    uint8_t right_vol;
+    uint8_t priority;
+    bool looping;
+    bool is_16bit;
+    bool is_signed;
+    bool is_adpcm;
+    uint8_t stream;
+#if SOUND_LOW_PASS
+    uint8_t alpha256;
+#endif
+} voice_start_t;
+
+typedef enum {
+    SND_CMD_START,
+    SND_CMD_STOP,
+    SND_CMD_STOP_ALL,
+    SND_CMD_PAN,
+    SND_CMD_STEP,
+    SND_CMD_END_LOOP,
+    SND_CMD_MUSIC,
+    SND_CMD_QUIT
+} sound_cmd_type_t;
+
+typedef struct {
+    uint8_t type;
+    uint8_t slot;
+    int handle;                    // Voice commands only apply to this handle
+    union {
+        voice_start_t start;
+        struct { uint8_t left, right; } pan;
+        uint32_t step;
+        void (*generator)(audio_buffer_t *buffer);
+    } u;
+} sound_cmd_t;
+
 //=============================================================================
 // Static Variables
 //=============================================================================
 
 static struct audio_buffer_pool *producer_pool = NULL;
 static bool sound_initialized = false;
-static voice_t voices[NUM_SOUND_CHANNELS];
+static voice_t voices[NUM_SOUND_CHANNELS];     // Owned by core1
 static int next_handle = 1;
 
+// Core0's view of the voice slots: the handle it last started in each slot
+// (0 once stopped) and that sound's priority. Core1 writes the handle of a
+// voice into voice_ended[] when it finishes or is stopped, so a slot is busy
+// while slot_handle != voice_ended.
+static int slot_handle[NUM_SOUND_CHANNELS];
+static uint8_t slot_priority[NUM_SOUND_CHANNELS];
+static volatile int voice_ended[NUM_SOUND_CHANNELS];
+
+// Core0 -> core1 command ring
+#define SOUND_CMD_RING 32
+static sound_cmd_t sound_cmds[SOUND_CMD_RING];
+static volatile uint32_t sound_cmd_head = 0;   // Written by core1
+static volatile uint32_t sound_cmd_tail = 0;   // Written by core0
+static volatile bool sound_core1_running = false;
+
+static uint32_t sound_core1_stack[1024];
+
 static int master_volume = 255;
 static bool reverse_stereo = false;
 static void (*sound_callback)(int32_t) = NULL;
@@ -96,6 +174,30 @@ static void (*music_generator)(audio_buffer_t *buffer) = NULL;
 static volatile uint32_t mix_iteration_count = 0;
 static volatile uint32_t last_reported_mix = 0;
 
+// Streamed voices. Core0 appends sample bytes at tail, core1 consumes from
+// head; both only ever grow, the ring index is taken modulo its size.
+#define MAX_SOUND_STREAMS 2
+#define STREAM_RING_BYTES 8192         // ~370ms of 22kHz 8-bit samples
+#define STREAM_REFILL_MIN 2048         // Batch SD reads into at least this much
+#define STREAM_UNDERRUN_SAMPLES VOICE_BUFFER_SAMPLES
+
+typedef struct {
+    sound_stream_t src;                // Core0 only from here...
+    uint32_t sample_pos;               // File offset of the first sample byte
+    uint32_t sample_length;
+    uint32_t remaining;                // Bytes left to read before the end/loop
+    int handle;                        // Voice playing from the ring
+    bool looping;
+    bool used;                         // ...to here
+    volatile bool eof;                 // Core0: tail will not grow any more
+    volatile bool released;            // Core1: no voice reads the ring any more
+    volatile uint32_t head;            // Written by core1
+    volatile uint32_t tail;            // Written by core0
+} sound_stream_state_t;
+
+static sound_stream_state_t streams[MAX_SOUND_STREAMS];
+static uint8_t stream_ring[MAX_SOUND_STREAMS][STREAM_RING_BYTES] __psram_bss("sound_stream_ring");
+
 // Deferred callback queue to avoid calling game code from mixer
 #define MAX_PENDING_CALLBACKS 32
 static volatile uint32_t pending_callbacks[MAX_PENDING_CALLBACKS];
@@ -186,10 +288,14 @@ static inline uint32_t read_le32(const uint8_t *p) {
 }
 
 // Find a free voice slot or steal one based on priority
+static inline bool slot_busy(int i) {
+    return slot_handle[i] != 0 && slot_handle[i] != voice_ended[i];
+}
+
 static int find_voice_slot(int priority) {
     // First, look for an inactive voice
     for (int i = 0; i < NUM_SOUND_CHANNELS; i++) {
-        if (!voices[i].active) {
+        if (!slot_busy(i)) {
             return i;
         }
     }
@@ -199,8 +305,8 @@ static int find_voice_slot(int priority) {
     int lowest_slot = -1;
     
     for (int i = 0; i < NUM_SOUND_CHANNELS; i++) {
-        if (voices[i].priority < lowest_priority) {
-            lowest_priority = voices[i].priority;
+        if (slot_priority[i] < lowest_priority) {
+            lowest_priority = slot_priority[i];
             lowest_slot = i;
         }
     }
@@ -213,15 +319,73 @@ static int handle_to_voice(int handle) {
     if (handle <= 0) return -1;
     // Handle encodes voice index in lower bits
     int voice_idx = (handle - 1) % NUM_SOUND_CHANNELS;
-    if (!voices[voice_idx].active) return -1;
+    if (slot_handle[voice_idx] != handle || !slot_busy(voice_idx)) return -1;
     return voice_idx;
 }
 
+// Queue a command for core1, waiting for room if the ring is full (core1
+// drains it between every mixed buffer). Returns the ring position just
+// past the command, for wait_command().
+static uint32_t post_command(const sound_cmd_t *cmd) {
+    if (!sound_core1_running) return sound_cmd_tail;
+    
+    while (sound_cmd_tail - sound_cmd_head >= SOUND_CMD_RING) {
+        tight_loop_contents();
+    }
+    sound_cmds[sound_cmd_tail % SOUND_CMD_RING] = *cmd;
+    __dmb();
+    sound_cmd_tail++;
+    return sound_cmd_tail;
+}
+
+// Wait until core1 has applied the command post_command() returned pos for.
+// Commands are applied between buffers, so core1 no longer reads the data of
+// a voice stopped by it.
+static void wait_command(uint32_t pos) {
+    while (sound_core1_running && (int32_t)(sound_cmd_head - pos) < 0) {
+        tight_loop_contents();
+    }
+}
+
+// Wait until core1 has applied everything posted so far
+static void wait_commands(void) {
+    while (sound_core1_running && sound_cmd_head != sound_cmd_tail) {
+        tight_loop_contents();
+    }
+}
+
+static uint32_t post_voice_command(uint8_t type, int slot, int handle) {
+    sound_cmd_t cmd;
+    cmd.type = type;
+    cmd.slot = slot;
+    cmd.handle = handle;
+    return post_command(&cmd);
+}
+
+// Hand a prepared voice to core1; returns its handle
+static int start_voice(int slot, const voice_start_t *start) {
+    sound_cmd_t cmd;
+    int handle = (next_handle++ % 10000) * NUM_SOUND_CHANNELS + slot + 1;
+    
+    slot_handle[slot] = handle;
+    slot_priority[slot] = start->priority;
+    
+    cmd.type = SND_CMD_START;
+    cmd.slot = slot;
+    cmd.handle = handle;
+    cmd.u.start = *start;
+    cmd.u.start.handle = handle;
+    post_command(&cmd);
+    
+    return handle;
+}
+
 // Queue a callback to be called later (from game thread, not mixer)
 static void queue_callback(uint32_t callback_val) {
     int next_tail = (pending_callback_tail + 1) % MAX_PENDING_CALLBACKS;
     if (next_tail != pending_callback_head) {
         pending_callbacks[pending_callback_tail] = callback_val;
+        __dmb();
         pending_callback_tail = next_tail;
     }
 }
@@ -241,6 +405,7 @@ static void process_pending_callbacks(void) {
     // Process up to a limited number to prevent infinite loops
     int processed = 0;
     while (pending_callback_head != pending_callback_tail && processed < 8) {
+        __dmb();
         uint32_t cb_val = pending_callbacks[pending_callback_head];
         pending_callback_head = (pending_callback_head + 1) % MAX_PENDING_CALLBACKS;
         processed++;
@@ -253,9 +418,71 @@ static void process_pending_callbacks(void) {
     processing_callbacks = false;
 }
 
+static void decode_block(voice_t *v);
+static void decode_stream_block(voice_t *v);
+
+// Top up a stream's ring from its source (core0). Reads are batched to
+// STREAM_REFILL_MIN unless that much is all that is left.
+static void refill_stream(sound_stream_state_t *st, uint8_t *ring) {
+    uint32_t space = STREAM_RING_BYTES - (st->tail - st->head);
+    
+    if (st->eof) return;
+    if (space < STREAM_REFILL_MIN && (st->looping || st->remaining > space)) return;
+    
+    while (space > 0) {
+        if (st->remaining == 0) {
+            if (!st->looping) {
+                __dmb();
+                st->eof = true;
+                return;
+            }
+            st->src.seek(st->src.ctx, st->sample_pos);
+            st->remaining = st->sample_length;
+        }
+        
+        uint32_t pos = st->tail % STREAM_RING_BYTES;
+        uint32_t n = STREAM_RING_BYTES - pos;
+        if (n > space) n = space;
+        if (n > st->remaining) n = st->remaining;
+        
+        int32_t got = st->src.read(st->src.ctx, ring + pos, (int32_t)n);
+        if (got <= 0) {
+            // Short file: end here rather than spin on it
+            st->remaining = 0;
+            st->looping = false;
+            continue;
+        }
+        
+        __dmb();
+        st->tail += (uint32_t)got;
+        space -= (uint32_t)got;
+        st->remaining -= (uint32_t)got;
+    }
+}
+
+// Refill live streams and close the ones core1 has let go of
+static void update_streams(void) {
+    for (int i = 0; i < MAX_SOUND_STREAMS; i++) {
+        sound_stream_state_t *st = &streams[i];
+        if (!st->used) continue;
+        
+        if (st->released) {
+            st->src.close(st->src.ctx);
+            st->used = false;
+            continue;
+        }
+        refill_stream(st, stream_ring[i]);
+    }
+}
+
 // Decompress/copy next block of samples into voice buffer
 // Called when buffer is exhausted during mixing (murmdoom pattern)
 static void decompress_buffer(voice_t *v) {
+    if (v->stream) {
+        decode_stream_block(v);
+        return;
+    }
+    
     // Validate pointers
     if (!v || !v->data || !v->data_end || v->data_end < v->data) {
         printf("DECOMPRESS: invalid ptrs data=%p end=%p\n", 
@@ -278,6 +505,11 @@ static void decompress_buffer(voice_t *v) {
         }
     }
     
+    decode_block(v);
+}
+
+// Decode up to VOICE_BUFFER_SAMPLES from v->data (which must be < data_end)
+static void decode_block(voice_t *v) {
     int samples_decoded = 0;
     
     if (v->is_adpcm) {
@@ -356,6 +588,37 @@ static void decompress_buffer(voice_t *v) {
     v->buffer_size = samples_decoded;
 }
 
+// Decode the next block of a streamed voice from the contiguous part of
+// its ring. Running dry before core0 has read the end plays silence.
+static void decode_stream_block(voice_t *v) {
+    sound_stream_state_t *st = &streams[v->stream - 1];
+    uint32_t head = st->head;
+    bool eof = st->eof;
+    __dmb();
+    uint32_t avail = st->tail - head;
+    uint32_t pos = head % STREAM_RING_BYTES;
+    uint32_t run = STREAM_RING_BYTES - pos;
+    
+    if (run > avail) run = avail;
+    if (run < (v->is_16bit ? 2u : 1u)) {
+        if (eof) {
+            v->buffer_size = 0;
+        } else {
+            memset(v->buffer, 0, STREAM_UNDERRUN_SAMPLES);
+            v->buffer_size = STREAM_UNDERRUN_SAMPLES;
+        }
+        return;
+    }
+    
+    const uint8_t *start = &stream_ring[v->stream - 1][pos];
+    v->data = start;
+    v->data_end = start + run;
+    decode_block(v);
+    
+    __dmb();
+    st->head = head + (uint32_t)(v->data - start);
+}
+
 // Stop a voice and optionally queue callback
 static void stop_voice(int voice_idx, bool do_callback) {
     if (voice_idx < 0 || voice_idx >= NUM_SOUND_CHANNELS) return;
@@ -366,6 +629,13 @@ static void stop_voice(int voice_idx, bool do_callback) {
     
     // Mark inactive
     v->active = false;
+    voice_ended[voice_idx] = v->handle;
+    
+    // Hand the ring back to core0
+    if (v->stream) {
+        streams[v->stream - 1].released = true;
+        v->stream = 0;
+    }
     
     // Queue callback if sound was playing and callback requested
     if (was_active && do_callback && cb_val != 0) {
@@ -380,11 +650,13 @@ static void stop_voice(int voice_idx, bool do_callback) {
 // Parse VOC file header and return sample data info
 // VOC format: "Creative Voice File" header, then blocks
 // Codec: 0=PCM, 4=ADPCM (4-bit)
-static bool parse_voc(const uint8_t *data, uint32_t length,
+// Only the first avail bytes of the length-byte file need to be in memory
+// (streamed sounds pass just the start of the file).
+static bool parse_voc(const uint8_t *data, uint32_t length, uint32_t avail,
                       const uint8_t **sample_data, uint32_t *sample_length,
                       uint32_t *sample_rate, bool *is_16bit, uint8_t *out_codec) {
     // Check for "Creative Voice File" header
-    if (length < 26) return false;
+    if (length < 26 || avail < 26) return false;
     if (memcmp(data, "Creative Voice File\x1a", 20) != 0) return false;
     
     uint16_t header_size = read_le16(data + 20);
@@ -392,12 +664,13 @@ static bool parse_voc(const uint8_t *data, uint32_t length,
     
     const uint8_t *block = data + header_size;
     const uint8_t *end = data + length;
+    const uint8_t *avail_end = data + avail;
     
     *is_16bit = false;
     *out_codec = 0;
     
     // Parse blocks to find sound data
-    while (block < end) {
+    while (block < end && block < avail_end) {
         uint8_t block_type = block[0];
         
         if (block_type == 0) {
@@ -405,7 +678,7 @@ static bool parse_voc(const uint8_t *data, uint32_t length,
             break;
         }
         
-        if (block + 4 > end) break;
+        if (block + 4 > end || block + 4 > avail_end) break;
         
         uint32_t block_size = block[1] | (block[2] << 8) | (block[3] << 16);
         const uint8_t *block_data = block + 4;
@@ -414,7 +687,7 @@ static bool parse_voc(const uint8_t *data, uint32_t length,
         
         switch (block_type) {
             case 1: // Sound data
-                if (block_size < 2) break;
+                if (block_size < 2 || block_data + 2 > avail_end) break;
                 {
                     uint8_t freq_div = block_data[0];
                     uint8_t codec = block_data[1];
@@ -433,7 +706,7 @@ static bool parse_voc(const uint8_t *data, uint32_t length,
                 }
                 
             case 9: // Sound data (new format)
-                if (block_size < 12) break;
+                if (block_size < 12 || block_data + 12 > avail_end) break;
                 {
                     *sample_rate = read_le32(block_data);
                     uint8_t bits = block_data[4];
@@ -588,7 +861,7 @@ static void mix_audio_buffer(audio_buffer_t *buffer) {
             uint32_t buf_idx = v->offset >> 16;
             if (buf_idx >= VOICE_BUFFER_SAMPLES) {
                 printf("MIX IDX OVERFLOW: ch=%d idx=%u\n", ch, buf_idx);
-                v->active = false;
+                stop_voice(ch, false);
                 break;
             }
             
@@ -621,7 +894,7 @@ static void mix_audio_buffer(audio_buffer_t *buffer) {
                 decompress_calls++;
                 if (decompress_calls > 20) {
                     printf("MIX: too many decompress ch=%d, stopping\n", ch);
-                    v->active = false;
+                    stop_voice(ch, false);
                     break;
                 }
                 
@@ -630,10 +903,7 @@ static void mix_audio_buffer(audio_buffer_t *buffer) {
                 offset_end = v->buffer_size * 65536;
                 if (offset_end == 0) {
                     // Sound finished or buffer empty - queue callback
-                    if (v->callback_val != 0) {
-                        queue_callback(v->callback_val);
-                    }
-                    v->active = false;
+                    stop_voice(ch, true);
                     break;
                 }
                 // Clamp offset to new buffer size
@@ -648,6 +918,116 @@ static void mix_audio_buffer(audio_buffer_t *buffer) {
     give_audio_buffer(producer_pool, buffer);
 }
 
+//=============================================================================
+// Core1 Audio Server
+//=============================================================================
+
+static void apply_start(int slot, const voice_start_t *start) {
+    voice_t *v = &voices[slot];
+    
+    stop_voice(slot, true);  // Stop any previous sound
+    
+    v->data = start->data;
+    v->data_end = start->data_end;
+    v->loop_start = start->loop_start;
+    v->loop_end = start->loop_end;
+    v->looping = start->looping;
+    v->is_16bit = start->is_16bit;
+    v->is_signed = start->is_signed;
+    v->is_adpcm = start->is_adpcm;
+    v->stream = start->stream;
+    
+    // Initialize Creative ADPCM state
+    if (v->is_adpcm) {
+        v->adpcm_pred = 128;  // Placeholder (first byte will replace)
+        v->adpcm_step = -1;   // -1 = needs to read first byte
+    }
+    
+    // Decompress first buffer block
+    decompress_buffer(v);
+    v->offset = 0;
+    
+    v->step = start->step;
+    v->left_vol = start->left_vol;
+    v->right_vol = start->right_vol;
+    v->priority = start->priority;
+    v->callback_val = start->callback_val;
+    v->handle = start->handle;
+#if SOUND_LOW_PASS
+    v->alpha256 = start->alpha256;
+#endif
+    
+    v->active = true;
+}
+
+// Apply queued commands; returns false once asked to quit
+static bool apply_commands(void) {
+    while (sound_cmd_head != sound_cmd_tail) {
+        __dmb();
+        const sound_cmd_t *cmd = &sound_cmds[sound_cmd_head % SOUND_CMD_RING];
+        voice_t *v = &voices[cmd->slot];
+        bool live = v->active && v->handle == cmd->handle;
+        
+        switch (cmd->type) {
+            case SND_CMD_START:
+                apply_start(cmd->slot, &cmd->u.start);
+                break;
+            case SND_CMD_STOP:
+                if (live) stop_voice(cmd->slot, false);  // Don't call callback when explicitly stopped
+                break;
+            case SND_CMD_STOP_ALL:
+                for (int i = 0; i < NUM_SOUND_CHANNELS; i++) {
+                    stop_voice(i, false);
+                }
+                break;
+            case SND_CMD_PAN:
+                if (live) {
+                    v->left_vol = cmd->u.pan.left;
+                    v->right_vol = cmd->u.pan.right;
+                }
+                break;
+            case SND_CMD_STEP:
+                if (live) v->step = cmd->u.step;
+                break;
+            case SND_CMD_END_LOOP:
+                if (live) {
+                    v->looping = false;
+                    v->loop_start = NULL;
+                }
+                break;
+            case SND_CMD_MUSIC:
+                music_generator = cmd->u.generator;
+                break;
+            case SND_CMD_QUIT:
+                __dmb();
+                sound_cmd_head++;
+                return false;
+        }
+        
+        __dmb();
+        sound_cmd_head++;
+    }
+    return true;
+}
+
+static void sound_core1_main(void) {
+    while (apply_commands()) {
+        audio_buffer_t *buffer = take_audio_buffer(producer_pool, false);
+        if (buffer) {
+            mix_audio_buffer(buffer);
+        } else {
+            // Pool full: a buffer drains every PICO_SOUND_BUFFER_SAMPLES,
+            // poll commands a few times per buffer meanwhile
+            busy_wait_us(500);
+        }
+    }
+    
+    sound_core1_running = false;
+    while (true) {
+        __wfe();
+    }
+}
+
 //=============================================================================
 // Public Interface
 //=============================================================================
@@ -692,6 +1072,15 @@ bool I_PicoSound_Init(int numvoices, int mixrate) {
     
     // Initialize voices
     memset(voices, 0, sizeof(voices));
+    memset(slot_handle, 0, sizeof(slot_handle));
+    for (int i = 0; i < NUM_SOUND_CHANNELS; i++) {
+        voice_ended[i] = 0;
+    }
+    sound_cmd_head = sound_cmd_tail = 0;
+    
+    // Hand the mixer to core1
+    sound_core1_running = true;
+    multicore_launch_core1_with_stack(sound_core1_main, sound_core1_stack, sizeof(sound_core1_stack));
     
     sound_initialized = true;
     return true;
@@ -700,7 +1089,21 @@ bool I_PicoSound_Init(int numvoices, int mixrate) {
 void I_PicoSound_Shutdown(void) {
     if (!sound_initialized) return;
     
+    // Let core1 finish its current buffer and park before stopping I2S
+    post_voice_command(SND_CMD_QUIT, 0, 0);
+    while (sound_core1_running) {
+        tight_loop_contents();
+    }
+    multicore_reset_core1();
+    
     audio_i2s_set_enabled(false);
+    
+    for (int i = 0; i < MAX_SOUND_STREAMS; i++) {
+        if (streams[i].used) {
+            streams[i].src.close(streams[i].src.ctx);
+            streams[i].used = false;
+        }
+    }
     sound_initialized = false;
 }
 
@@ -720,19 +1123,9 @@ void I_PicoSound_Update(void) {
     }
 #endif
     
-    // Process audio buffers - decompress_buffer is called inline during mixing
-    // This is the murmdoom pattern: PSRAM access happens inside the mix loop
-    audio_buffer_t *buffer;
-    int buffers_processed = 0;
-    while ((buffer = take_audio_buffer(producer_pool, false)) != NULL) {
-        mix_audio_buffer(buffer);
-        buffers_processed++;
-        if (buffers_processed > 10) {
-            break;
-        }
-    }
-    
-    // Process any pending callbacks from finished sounds
+    // Mixing happens on core1; feed its streams and run the callbacks of
+    // sounds that finished
+    update_streams();
     process_pending_callbacks();
 }
 
@@ -753,7 +1146,7 @@ int I_PicoSound_PlayVOC(const uint8_t *data, uint32_t length,
     uint8_t codec = 0;
     
     // Parse VOC header
-    if (!parse_voc(data, length, &sample_data, &sample_length, &sample_rate, &is_16bit, &codec)) {
+    if (!parse_voc(data, length, length, &sample_data, &sample_length, &sample_rate, &is_16bit, &codec)) {
         // Fallback: treat entire data as raw 8-bit unsigned samples
         sample_data = data;
         sample_length = length;
@@ -769,8 +1162,9 @@ int I_PicoSound_PlayVOC(const uint8_t *data, uint32_t length,
     int slot = find_voice_slot(priority);
     if (slot < 0) return 0;
     
-    voice_t *v = &voices[slot];
-    stop_voice(slot, true);
+    voice_start_t start;
+    voice_start_t *v = &start;
+    memset(v, 0, sizeof(*v));
     
     v->data = sample_data;
     v->data_end = sample_data + sample_length;
@@ -785,16 +1179,6 @@ int I_PicoSound_PlayVOC(const uint8_t *data, uint32_t length,
     v->is_signed = false;  // VOC 8-bit is unsigned
     v->is_adpcm = is_adpcm;
     
-    // Initialize Creative ADPCM state
-    if (is_adpcm) {
-        v->adpcm_pred = 128;  // Placeholder (first byte will replace)
-        v->adpcm_step = -1;   // -1 = needs to read first byte
-    }
-    
-    // Decompress first buffer block
-    decompress_buffer(v);
-    v->offset = 0;
-    
     // Calculate step: input_rate / output_rate in 16.16 fixed point
     int32_t rate = (int32_t)sample_rate;
     if (pitchoffset != 0) {
@@ -821,10 +1205,95 @@ int I_PicoSound_PlayVOC(const uint8_t *data, uint32_t length,
     v->alpha256 = (256 * 201 * sample_rate) / (201 * sample_rate + 64 * PICO_SOUND_SAMPLE_FREQ);
 #endif
     
-    v->active = true;
+    return start_voice(slot, v);
+}
+
+int I_PicoSound_PlayVOCStream(const uint8_t *header, uint32_t header_length,
+                              uint32_t file_length, const sound_stream_t *stream,
+                              int pitchoffset, int vol, int left, int right,
+                              int priority, uint32_t callbackval, bool looping) {
+    if (!sound_initialized) return 0;
     
-    int handle = (next_handle++ % 10000) * NUM_SOUND_CHANNELS + slot + 1;
-    return handle;
+    const uint8_t *sample_data;
+    uint32_t sample_length, sample_rate;
+    bool is_16bit;
+    uint8_t codec = 0;
+    
+    if (!parse_voc(header, file_length, header_length, &sample_data, &sample_length, &sample_rate, &is_16bit, &codec)) {
+        return 0;
+    }
+    
+    // A looped ADPCM sound would need its decoder reset at the loop point,
+    // which core1 cannot see in the ring
+    if (codec == 4 && looping) return 0;
+    
+    uint32_t sample_pos = (uint32_t)(sample_data - header);
+    if (sample_pos > header_length) return 0;
+    
+    int idx;
+    for (idx = 0; idx < MAX_SOUND_STREAMS; idx++) {
+        if (!streams[idx].used) break;
+    }
+    if (idx == MAX_SOUND_STREAMS) return 0;
+    
+    int slot = find_voice_slot(priority);
+    if (slot < 0) return 0;
+    
+    // Whatever sample bytes came with the header go in first; the source is
+    // positioned right after them
+    sound_stream_state_t *st = &streams[idx];
+    uint32_t in_header = header_length - sample_pos;
+    if (in_header > sample_length) in_header = sample_length;
+    
+    st->src = *stream;
+    st->sample_pos = sample_pos;
+    st->sample_length = sample_length;
+    st->remaining = sample_length - in_header;
+    st->looping = looping;
+    st->eof = false;
+    st->released = false;
+    st->head = 0;
+    memcpy(stream_ring[idx], sample_data, in_header);
+    st->tail = in_header;
+    st->used = true;
+    
+    // Fill the ring before the voice starts so it does not open on silence
+    refill_stream(st, stream_ring[idx]);
+    
+    voice_start_t start;
+    voice_start_t *v = &start;
+    memset(v, 0, sizeof(*v));
+    
+    v->stream = idx + 1;
+    v->is_16bit = is_16bit;
+    v->is_signed = false;  // VOC 8-bit is unsigned
+    v->is_adpcm = (codec == 4);
+    
+    int32_t rate = (int32_t)sample_rate;
+    if (pitchoffset != 0) {
+        rate = rate + (rate * pitchoffset / 2048);
+        if (rate < 1000) rate = 1000;
+        if (rate > 48000) rate = 48000;
+    }
+    v->step = ((uint64_t)rate << 16) / PICO_SOUND_SAMPLE_FREQ;
+    
+    if (left <= 0 && right <= 0 && vol > 0) {
+        left = vol;
+        right = vol;
+    }
+    left = left * 4;
+    right = right * 4;
+    v->left_vol = left > 255 ? 255 : (left < 0 ? 0 : left);
+    v->right_vol = right > 255 ? 255 : (right < 0 ? 0 : right);
+    v->priority = priority;
+    v->callback_val = callbackval;
+
+#if SOUND_LOW_PASS
+    v->alpha256 = (256 * 201 * sample_rate) / (201 * sample_rate + 64 * PICO_SOUND_SAMPLE_FREQ);
+#endif
+    
+    st->handle = start_voice(slot, v);
+    return st->handle;
 }
 
 int I_PicoSound_PlayWAV(const uint8_t *data, uint32_t length,
@@ -847,8 +1316,9 @@ int I_PicoSound_PlayWAV(const uint8_t *data, uint32_t length,
     int slot = find_voice_slot(priority);
     if (slot < 0) return 0;
     
-    voice_t *v = &voices[slot];
-    stop_voice(slot, true);  // Stop any previous sound
+    voice_start_t start;
+    voice_start_t *v = &start;
+    memset(v, 0, sizeof(*v));
     
     v->data = sample_data;
     v->data_end = sample_data + sample_length;
@@ -863,10 +1333,6 @@ int I_PicoSound_PlayWAV(const uint8_t *data, uint32_t length,
     v->is_signed = is_signed;
     v->is_adpcm = false;  // WAV files are not ADPCM
     
-    // Decompress first buffer block
-    decompress_buffer(v);
-    v->offset = 0;
-    
     // Calculate step: input_rate / output_rate in 16.16 fixed point
     // Apply pitch offset (signed operation to handle negative pitch)
     int32_t rate = (int32_t)sample_rate;
@@ -895,10 +1361,7 @@ int I_PicoSound_PlayWAV(const uint8_t *data, uint32_t length,
     v->alpha256 = (256 * 201 * sample_rate) / (201 * sample_rate + 64 * PICO_SOUND_SAMPLE_FREQ);
 #endif
     
-    v->active = true;
-    
-    int handle = (next_handle++ % 10000) * NUM_SOUND_CHANNELS + slot + 1;
-    return handle;
+    return start_voice(slot, v);
 }
 
 int I_PicoSound_PlayRaw(const uint8_t *data, uint32_t length,
@@ -915,8 +1378,9 @@ int I_PicoSound_PlayRaw(const uint8_t *data, uint32_t length,
         return 0;
     }
     
-    voice_t *v = &voices[slot];
-    stop_voice(slot, true);  // Stop any previous sound
+    voice_start_t start;
+    voice_start_t *v = &start;
+    memset(v, 0, sizeof(*v));
     
     v->data = data;
     v->data_end = data + length;
@@ -928,10 +1392,6 @@ int I_PicoSound_PlayRaw(const uint8_t *data, uint32_t length,
     v->is_signed = false;
     v->is_adpcm = false;  // Raw data is not ADPCM
     
-    // Decompress first buffer block
-    decompress_buffer(v);
-    v->offset = 0;
-    
     // Calculate step: input_rate / output_rate in 16.16 fixed point
     int32_t rate = (int32_t)samplerate;
     if (pitchoffset != 0) {
@@ -958,37 +1418,34 @@ int I_PicoSound_PlayRaw(const uint8_t *data, uint32_t length,
     v->alpha256 = (256 * 201 * samplerate) / (201 * samplerate + 64 * PICO_SOUND_SAMPLE_FREQ);
 #endif
     
-    v->active = true;
-    
-    int handle = (next_handle++ % 10000) * NUM_SOUND_CHANNELS + slot + 1;
-    
-    return handle;
+    return start_voice(slot, v);
 }
 
+// Stops return only once core1 has let go of the sample data: the caller
+// unlocks the cache block right after, and it may be reused at once.
 int I_PicoSound_StopVoice(int handle) {
     int slot = handle_to_voice(handle);
     if (slot >= 0) {
-        stop_voice(slot, false);  // Don't call callback when explicitly stopped
+        slot_handle[slot] = 0;
+        wait_command(post_voice_command(SND_CMD_STOP, slot, handle));
         return 1;
     }
     return 0;
 }
 
 void I_PicoSound_StopAllVoices(void) {
-    for (int i = 0; i < NUM_SOUND_CHANNELS; i++) {
-        stop_voice(i, false);
-    }
+    memset(slot_handle, 0, sizeof(slot_handle));
+    wait_command(post_voice_command(SND_CMD_STOP_ALL, 0, 0));
 }
 
 bool I_PicoSound_VoicePlaying(int handle) {
-    int slot = handle_to_voice(handle);
-    return slot >= 0 && voices[slot].active;
+    return handle_to_voice(handle) >= 0;
 }
 
 int I_PicoSound_VoicesPlaying(void) {
     int count = 0;
     for (int i = 0; i < NUM_SOUND_CHANNELS; i++) {
-        if (voices[i].active) count++;
+        if (slot_busy(i)) count++;
     }
     return count;
 }
@@ -997,12 +1454,23 @@ bool I_PicoSound_VoiceAvailable(int priority) {
     return find_voice_slot(priority) >= 0;
 }
 
+static void post_pan(int slot, int handle, int left, int right) {
+    sound_cmd_t cmd;
+    cmd.type = SND_CMD_PAN;
+    cmd.slot = slot;
+    cmd.handle = handle;
+    cmd.u.pan.left = left;
+    cmd.u.pan.right = right;
+    post_command(&cmd);
+}
+
 void I_PicoSound_SetPan(int handle, int vol, int left, int right) {
     int slot = handle_to_voice(handle);
     if (slot < 0) return;
     
-    voices[slot].left_vol = left > 255 ? 255 : (left < 0 ? 0 : left);
-    voices[slot].right_vol = right > 255 ? 255 : (right < 0 ? 0 : right);
+    post_pan(slot, handle,
+             left > 255 ? 255 : (left < 0 ? 0 : left),
+             right > 255 ? 255 : (right < 0 ? 0 : right));
 }
 
 void I_PicoSound_SetPitch(int handle, int pitchoffset) {
@@ -1013,15 +1481,25 @@ void I_PicoSound_SetFrequency(int handle, int frequency) {
     int slot = handle_to_voice(handle);
     if (slot < 0) return;
     
-    voices[slot].step = ((uint32_t)frequency << 16) / PICO_SOUND_SAMPLE_FREQ;
+    sound_cmd_t cmd;
+    cmd.type = SND_CMD_STEP;
+    cmd.slot = slot;
+    cmd.handle = handle;
+    cmd.u.step = ((uint32_t)frequency << 16) / PICO_SOUND_SAMPLE_FREQ;
+    post_command(&cmd);
 }
 
 void I_PicoSound_EndLooping(int handle) {
     int slot = handle_to_voice(handle);
     if (slot < 0) return;
     
-    voices[slot].looping = false;
-    voices[slot].loop_start = NULL;
+    // A streamed voice loops by core0 rewinding its source
+    for (int i = 0; i < MAX_SOUND_STREAMS; i++) {
+        if (streams[i].used && !streams[i].released && streams[i].handle == handle) {
+            streams[i].looping = false;
+        }
+    }
+    post_voice_command(SND_CMD_END_LOOP, slot, handle);
 }
 
 void I_PicoSound_Pan3D(int handle, int angle, int distance) {
@@ -1043,8 +1521,7 @@ void I_PicoSound_Pan3D(int handle, int angle, int distance) {
         pan = (256 - angle) * 2;
     }
     
-    voices[slot].left_vol = (vol * (255 - pan)) >> 8;
-    voices[slot].right_vol = (vol * pan) >> 8;
+    post_pan(slot, handle, (vol * (255 - pan)) >> 8, (vol * pan) >> 8);
 }
 
 void I_PicoSound_SetVolume(int volume) {
@@ -1067,6 +1544,19 @@ void I_PicoSound_SetCallback(void (*callback)(int32_t)) {
     sound_callback = callback;
 }
 
+// Synchronous: once this returns core1 is no longer inside the previous
+// generator, so the caller may free or rewrite its state
 void I_PicoSound_SetMusicGenerator(void (*generator)(audio_buffer_t *buffer)) {
-    music_generator = generator;
+    if (!sound_core1_running) {
+        music_generator = generator;
+        return;
+    }
+    
+    sound_cmd_t cmd;
+    cmd.type = SND_CMD_MUSIC;
+    cmd.slot = 0;
+    cmd.handle = 0;
+    cmd.u.generator = generator;
+    post_command(&cmd);
+    wait_commands();
 }
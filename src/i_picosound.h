@@ -56,7 +56,7 @@ bool I_PicoSound_Init(int numvoices, int mixrate);
 void I_PicoSound_Shutdown(void);
 
 // Update sound - call once per game tick
-// This mixes audio and sends buffers to I2S
+// Runs the callbacks of sounds that finished; mixing happens on core1
 void I_PicoSound_Update(void);
 
 // Check if sound system is initialized
@@ -90,6 +90,23 @@ int I_PicoSound_PlayRaw(const uint8_t *data, uint32_t length,
                         int priority, uint32_t callbackval,
                         bool looping, const uint8_t *loopstart, const uint8_t *loopend);
 
+// Source of a streamed sound's file, read on core0 from I_PicoSound_Update
+typedef struct {
+    int32_t (*read)(void *ctx, uint8_t *dst, int32_t len);  // Bytes read, <= 0 at end
+    void (*seek)(void *ctx, uint32_t pos);                   // Absolute file offset
+    void (*close)(void *ctx);
+    void *ctx;
+} sound_stream_t;
+
+// Play a VOC sound by streaming it instead of holding it in memory
+// header holds the first header_length bytes of the file and stream is
+// positioned right after them. On success the sound system owns the stream
+// and closes it when the voice ends; on failure (0) the caller still does.
+int I_PicoSound_PlayVOCStream(const uint8_t *header, uint32_t header_length,
+                              uint32_t file_length, const sound_stream_t *stream,
+                              int pitchoffset, int vol, int left, int right,
+                              int priority, uint32_t callbackval, bool looping);
+
 // Stop a sound by voice handle
 int I_PicoSound_StopVoice(int handle);
 
@@ -88,6 +88,9 @@ int main() {
     uint psram_pin = get_psram_pin();
     psram_init(psram_pin);
 
+    // Claim the DMA channels used for bulk copies
+    dmacopy_init();
+
     // Initialize PSRAM linker sections (copy .psram_data, zero .psram_bss)
     psram_sections_init();
 
@@ -74,8 +74,6 @@ int32_t *lastx = NULL;
 int32_t *slopalookup = NULL;
 short *radarang = NULL;
 short *radarang2 = NULL;
-uint16_t *sqrtable = NULL;
-uint16_t *shlookup = NULL;
 
 /* ============== Game Arrays (from global.c/duke3d.h) ============== */
 
@@ -157,8 +155,6 @@ void psram_data_init(void) {
     PSRAM_ALLOC(slopalookup, int32_t, 16384, "slopalookup");
     PSRAM_ALLOC(radarang, short, 1280, "radarang");
     PSRAM_ALLOC(radarang2, short, MAXXDIM + 1, "radarang2");
-    PSRAM_ALLOC(sqrtable, uint16_t, 4096, "sqrtable");
-    PSRAM_ALLOC(shlookup, uint16_t, 4096 + 256, "shlookup");
     
     /* Game arrays from global.c */
     PSRAM_ALLOC(hittype, struct weaponhit, MAXSPRITES, "hittype");
@@ -10,6 +10,7 @@
 
 #include <stdint.h>
 #include <string.h>
+#include "dma_copy.h"
 
 /* Linker symbols for PSRAM sections */
 extern uint8_t __psram_data_start__[];
@@ -25,19 +26,19 @@ extern uint8_t __psram_heap_start__[];
 /* Place variable in PSRAM data section (initialized from flash) */
 #define __psram_data(name) __attribute__((section(".psram_data." name)))
 
-/* Initialize PSRAM sections - call this early in main() after PSRAM init */
+/* Initialize PSRAM sections - call this early in main() after PSRAM init and dmacopy_init() */
 static inline void psram_sections_init(void) {
-    /* Copy .psram_data from flash to PSRAM */
+    /* Zero .psram_bss in PSRAM on a DMA channel (needs dmacopy_init) */
+    size_t psram_bss_size = __psram_bss_end__ - __psram_bss_start__;
+    dmacopy_fence_t bss_fence = dmacopy_memset(__psram_bss_start__, 0, psram_bss_size);
+
+    /* ...while the CPU copies .psram_data from flash to PSRAM */
     size_t psram_data_size = __psram_data_end__ - __psram_data_start__;
     if (psram_data_size > 0) {
         memcpy(__psram_data_start__, __psram_data_load__, psram_data_size);
     }
-    
-    /* Zero .psram_bss in PSRAM */
-    size_t psram_bss_size = __psram_bss_end__ - __psram_bss_start__;
-    if (psram_bss_size > 0) {
-        memset(__psram_bss_start__, 0, psram_bss_size);
-    }
+
+    dmacopy_wait(bss_fence);
 }
 
 /* Get PSRAM heap start for dynamic allocation */
@@ -12,6 +12,7 @@
 #include "SDL_video.h"
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 #include <math.h>
 
 // Version injected by CMake
@@ -37,6 +38,11 @@ extern uint8_t FRAME_BUF[];
 
 static bool return_to_welcome = false;
 
+// Speculative GRP read-ahead (fatfs_stdio.c)
+extern int fatfs_warm_begin(const char *path);
+extern const void *fatfs_warm_read(FSIZE_t offset, UINT len);
+extern void fatfs_warm_cancel(void);
+
 //=============================================================================
 // 5x7 Bitmap Font (from murmdoom)
 //=============================================================================
@@ -350,6 +356,111 @@ static void scan_grp_files(void) {
     }
 }
 
+//=============================================================================
+// GRP Warm-up
+//=============================================================================
+
+// While the menu sits idle, the highlighted GRP is opened and the reads the
+// engine starts with (directory, ART headers, palette, lookup and tables)
+// are pulled into the fatfs_stdio warm cache a few steps per frame. The
+// game's open() of the same file picks up whatever is done by then; moving
+// the selection or choosing another GRP cancels it.
+
+#define WARM_SETTLE_MS  250          // Selection must rest this long first
+#define WARM_FRAME_MS   8            // Warm-up time spent per menu frame
+#define WARM_STEP_BYTES (16 * 1024)  // Largest single read
+
+static const char *const warm_names[] = { "PALETTE.DAT", "LOOKUP.DAT", "TABLES.DAT" };
+
+static int warm_grp = -1;        // available_grps index being warmed, -1 if none
+static bool warm_done;
+static int warm_stage;
+static uint32_t warm_numfiles;
+static const uint8_t *warm_dir;  // GRP directory, inside the warm cache
+static uint32_t warm_entry;      // Next directory entry to look at
+static uint32_t warm_offset;     // GRP offset of warm_entry's data
+static uint32_t warm_at;         // Read in progress
+static uint32_t warm_left;
+
+static uint32_t get_le32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void warm_cancel(void) {
+    fatfs_warm_cancel();
+    warm_grp = -1;
+}
+
+static void warm_begin(int grp) {
+    char path[64];
+
+    warm_grp = grp;
+    warm_done = false;
+    warm_stage = 0;
+    warm_left = 0;
+    snprintf(path, sizeof(path), "/duke3d/%s", available_grps[grp]->filename);
+    if (fatfs_warm_begin(path) != 0) warm_done = true;
+}
+
+// One bounded piece of warm-up work; sets warm_done when nothing is left
+static void warm_step(void) {
+    const uint8_t *p;
+
+    if (warm_left > 0) {
+        uint32_t n = warm_left < WARM_STEP_BYTES ? warm_left : WARM_STEP_BYTES;
+        if (!fatfs_warm_read(warm_at, n)) { warm_done = true; return; }
+        warm_at += n;
+        warm_left -= n;
+        return;
+    }
+
+    switch (warm_stage) {
+    case 0:  // "KenSilverman" + file count
+        p = fatfs_warm_read(0, 16);
+        if (!p || memcmp(p, "KenSilverman", 12) != 0) { warm_done = true; return; }
+        warm_numfiles = get_le32(p + 12);
+        warm_stage = 1;
+        return;
+
+    case 1:  // 16-byte entries: name[12], size
+        warm_dir = fatfs_warm_read(16, warm_numfiles * 16);
+        if (!warm_dir) { warm_done = true; return; }
+        warm_entry = 0;
+        warm_offset = 16 + warm_numfiles * 16;
+        warm_stage = 2;
+        return;
+
+    default:
+        while (warm_entry < warm_numfiles) {
+            const char *name = (const char *)(warm_dir + warm_entry * 16);
+            uint32_t size = get_le32(warm_dir + warm_entry * 16 + 12);
+            uint32_t at = warm_offset;
+
+            warm_entry++;
+            warm_offset += size;
+
+            // TILESnnn.ART: the header plus the per-tile size and anim arrays
+            if (strncasecmp(name, "TILES", 5) == 0 && strncasecmp(name + 8, ".ART", 4) == 0 && size >= 16) {
+                p = fatfs_warm_read(at, 16);
+                if (!p) { warm_done = true; return; }
+                warm_at = at + 16;
+                warm_left = (get_le32(p + 12) - get_le32(p + 8) + 1) * 8;
+                if (warm_left > size - 16) warm_left = size - 16;
+                return;
+            }
+            for (size_t i = 0; i < sizeof(warm_names) / sizeof(warm_names[0]); ++i) {
+                if (strncasecmp(name, warm_names[i], 12) == 0) {
+                    warm_at = at;
+                    warm_left = size;
+                    return;
+                }
+            }
+        }
+        warm_done = true;
+        return;
+    }
+}
+
 //=============================================================================
 // Menu Rendering
 //=============================================================================
@@ -488,8 +599,13 @@ const char *welcome_show(void) {
     const int line_h = 10;
     const int menu_w = panel_w - 16;
 
-    int selected = 0;
+    static int last_selected = 0;
+    int selected = last_selected < available_count ? last_selected : 0;
     int prev_selected = -1;
+    uint32_t selected_ms = 0;
+
+    // The previous game's GRP handle may still hold the warm cache
+    warm_cancel();
 
     // Build title strings
     char title_right[64];
@@ -536,6 +652,17 @@ const char *welcome_show(void) {
         if (prev_selected != selected) {
             render_menu(selected, menu_x, menu_y, menu_w, line_h);
             prev_selected = selected;
+            selected_ms = now_ms;
+            if (warm_grp >= 0) warm_cancel();
+        }
+
+        // Read ahead from the highlighted GRP once the selection settles
+        if (available_count > 0 && warm_grp < 0 && now_ms - selected_ms >= WARM_SETTLE_MS) {
+            warm_begin(selected);
+        }
+        while (warm_grp >= 0 && !warm_done &&
+               to_ms_since_boot(get_absolute_time()) - now_ms < WARM_FRAME_MS) {
+            warm_step();
         }
 
         // Handle keyboard input
@@ -545,6 +672,9 @@ const char *welcome_show(void) {
             if (!pressed) continue;
 
             if (key == sc_Return && available_count > 0) {
+                if (warm_grp != selected) warm_cancel();
+                last_selected = selected;
+
                 // Show loading message
                 fill_rect(panel_x, panel_y, panel_w, panel_h, 0);
                 char msg[64];
@@ -0,0 +1,114 @@
+/*
+ * Host check of the PSRAM timing sweep in drivers/psram_calibrate.c against a
+ * simulated memory that passes only inside a per-divisor rxdelay window.
+ *
+ *   cc -Idrivers -o psram_calibrate_test tools/psram_calibrate_test.c drivers/psram_calibrate.c
+ *   ./psram_calibrate_test
+ */
+#include "psram_calibrate.h"
+#include <stdio.h>
+
+#define MAX_DIVISOR 8
+
+typedef struct {
+    int lo[MAX_DIVISOR + 1];  // Passing rxdelays are lo..hi, none if lo > hi
+    int hi[MAX_DIVISOR + 1];
+    int divisor, rxdelay;     // Currently applied timing
+    int applies;
+} sim_t;
+
+static void sim_apply(void *ctx, int divisor, int rxdelay) {
+    sim_t *sim = ctx;
+    sim->divisor = divisor;
+    sim->rxdelay = rxdelay;
+    sim->applies++;
+}
+
+static int sim_test(void *ctx) {
+    sim_t *sim = ctx;
+    return sim->rxdelay >= sim->lo[sim->divisor] && sim->rxdelay <= sim->hi[sim->divisor];
+}
+
+static void sim_init(sim_t *sim) {
+    for (int d = 0; d <= MAX_DIVISOR; d++) {
+        sim->lo[d] = 1;
+        sim->hi[d] = 0;
+    }
+    sim->applies = 0;
+}
+
+static int failures;
+
+static void expect(const char *name, sim_t *sim, int min_div, int rated_div, int max_div,
+                   int ok, int divisor, int rxdelay) {
+    psram_cal_ops_t ops = { sim_apply, sim_test, sim };
+    psram_cal_result_t res = { -1, -1, -1 };
+    int got = psram_calibrate(&ops, min_div, rated_div, max_div, &res);
+
+    if (got != ok || (ok && (res.divisor != divisor || res.rxdelay != rxdelay)) ||
+        (!ok && res.divisor != -1) || (got && res.divisor > max_div)) {
+        printf("FAIL %s: got %d div %d rx %d, want %d div %d rx %d\n",
+               name, got, res.divisor, res.rxdelay, ok, divisor, rxdelay);
+        failures++;
+    } else {
+        printf("ok   %s\n", name);
+    }
+}
+
+int main(void) {
+    sim_t sim;
+
+    // Wide window at the rated divisor: middle of 2..6, rounded up
+    sim_init(&sim);
+    sim.lo[2] = 2; sim.hi[2] = 6;
+    expect("wide window at rated divisor", &sim, 2, 2, 2, 1, 2, 4);
+
+    // Faster than the formula's bumped divisor when the rated one passes
+    sim_init(&sim);
+    sim.lo[1] = 1; sim.hi[1] = 4;
+    sim.lo[2] = 2; sim.hi[2] = 7;
+    expect("rated divisor below formula", &sim, 1, 1, 2, 1, 1, 3);
+
+    // Narrow window at the fastest divisor moves on to the next one
+    sim_init(&sim);
+    sim.lo[1] = 3; sim.hi[1] = 4;
+    sim.lo[2] = 1; sim.hi[2] = 5;
+    expect("narrow window skipped", &sim, 1, 1, 2, 1, 2, 3);
+
+    // Narrow window at the formula divisor: never go slower, report failure
+    // so the caller keeps the formula timing
+    sim_init(&sim);
+    sim.lo[2] = 3; sim.hi[2] = 4;
+    sim.lo[3] = 0; sim.hi[3] = 7;
+    expect("no slower than formula", &sim, 2, 2, 2, 0, 0, 0);
+
+    // Window reaching the top rxdelay is closed by the sweep
+    sim_init(&sim);
+    sim.lo[3] = 4; sim.hi[3] = PSRAM_CAL_MAX_RXDELAY;
+    expect("window at top rxdelay", &sim, 3, 3, 3, 1, 3, 6);
+
+    // Every rxdelay passes
+    sim_init(&sim);
+    sim.lo[2] = 0; sim.hi[2] = PSRAM_CAL_MAX_RXDELAY;
+    expect("full window", &sim, 2, 2, 2, 1, 2, 4);
+
+    // Nothing passes
+    sim_init(&sim);
+    expect("nothing passes", &sim, 1, 1, 3, 0, 0, 0);
+
+    // Past the rated clock a window that would do at the rated one is not
+    // enough, the rated divisor wins
+    sim_init(&sim);
+    sim.lo[2] = 2; sim.hi[2] = 5;
+    sim.lo[3] = 1; sim.hi[3] = 6;
+    expect("narrow window past rating", &sim, 2, 3, 3, 1, 3, 4);
+
+    // A wide window past the rated clock is taken
+    sim_init(&sim);
+    sim.lo[2] = 1; sim.hi[2] = 5;
+    sim.lo[3] = 0; sim.hi[3] = 7;
+    expect("faster than rated", &sim, 2, 3, 3, 1, 2, 3);
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+    return failures != 0;
+}